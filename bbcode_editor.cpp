@@ -42,5 +42,18 @@
 
 #include "bbcode_editor.h"
 
+#include "editor/sd_TypefaceNameCache.cpp"
+#include "editor/sd_FontCache.cpp"
 #include "editor/sd_TextFormatState.cpp"
-#include "editor/sd_BBcodeEditor.cpp"
\ No newline at end of file
+#include "editor/sd_BBCodeTagRegistry.cpp"
+#include "editor/sd_BBCodeTokenizer.cpp"
+#include "editor/sd_FormatStateTable.cpp"
+#include "editor/sd_BBCodeParser.cpp"
+#include "editor/sd_BBDocumentCache.cpp"
+#include "editor/sd_CompiledBBDocument.cpp"
+#include "editor/sd_BBAttributedString.cpp"
+#include "editor/sd_BBPlainText.cpp"
+#include "editor/sd_BBCodeBatch.cpp"
+#include "editor/sd_BBCodeStreamParser.cpp"
+#include "editor/sd_BBcodeEditor.cpp"
+#include "editor/sd_BBCodeView.cpp"
\ No newline at end of file
@@ -61,13 +61,53 @@ END_JUCE_MODULE_DECLARATION
 #ifndef BBCODE_EDITOR_HEADER_H
 #define BBCODE_EDITOR_HEADER_H
 
+//==============================================================================
+/** Config: BBCODE_EDITOR_ENABLE_STATS
+    Collects sd::ParseStats for every parse and editor update, see BBCodeEditor::getLastParseStats().
+    When disabled, none of the counting and timing code is compiled in.
+*/
+#ifndef BBCODE_EDITOR_ENABLE_STATS
+ #define BBCODE_EDITOR_ENABLE_STATS 0
+#endif
+
+/** Config: BBCODE_EDITOR_USE_SIMD
+    Lets the tokenizer scan for '[' and ']' 16 or 32 bytes at a time with SSE2, AVX2 or NEON,
+    whichever the CPU supports. When disabled, or on other CPUs, a plain loop is used.
+*/
+#ifndef BBCODE_EDITOR_USE_SIMD
+ #define BBCODE_EDITOR_USE_SIMD 1
+#endif
+
 // clang-format off
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <map>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
+#include "editor/sd_TypefaceNameCache.h"
+#include "editor/sd_FontCache.h"
 #include "editor/sd_TextFormatState.h"
+#include "editor/sd_BBCodeTagRegistry.h"
+#include "editor/sd_BBCodeTokenizer.h"
+#include "editor/sd_BBDocument.h"
+#include "editor/sd_ParseStats.h"
+#include "editor/sd_FormatStateTable.h"
+#include "editor/sd_BBCodeParser.h"
+#include "editor/sd_BBDocumentCache.h"
+#include "editor/sd_CompiledBBDocument.h"
+#include "editor/sd_BBAttributedString.h"
+#include "editor/sd_BBPlainText.h"
+#include "editor/sd_BBCodeBatch.h"
+#include "editor/sd_BBCodeStreamParser.h"
 
 #include "editor/sd_BBcodeEditor.h"
+#include "editor/sd_BBCodeView.h"
 // clang-format on
 
 #endif  // BBCODE_EDITOR_HEADER_H
@@ -0,0 +1,407 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeBenchmark.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+
+    Headless benchmark of the bbcode_editor module.
+
+    Generates reproducible BBCode corpora (fixed seeds) from 1 KB up to 10 MB and times:
+      - tokenize : BBCodeTokenizer over the whole text.
+      - withToken: TextFormatState::withToken for every tag.
+      - colour   : TextFormatState::withToken for every [color] tag only.
+      - parse    : BBCodeParser::parse.
+      - setBBText: BBCodeEditor::setBBText into an empty editor that is never shown.
+      - editTail : BBCodeEditor::setBBText with the last line edited, into an editor showing
+                   the original text. Only the text after the edit is parsed and rendered again.
+
+    Reports the best time of a number of iterations in ns per corpus byte, and the heap
+    allocations of one iteration.
+
+    Usage: BBCodeBenchmark [--max-size <bytes>] [--editor-max-size <bytes>] [--csv]
+
+  =====================================================================================================
+*/
+
+#include <bbcode_editor.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+//==============================================================================
+// Counts every heap allocation made by the process...
+
+namespace
+{
+std::atomic<juce::uint64> gNumAllocations { 0 };
+}  // namespace
+
+void* operator new( std::size_t size )
+{
+    gNumAllocations.fetch_add( 1, std::memory_order_relaxed );
+    if( auto* memory = std::malloc( size > 0 ? size : 1 ) )
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete( void* memory, std::size_t ) noexcept
+{
+    std::free( memory );
+}
+
+void operator delete[]( void* memory, std::size_t ) noexcept
+{
+    std::free( memory );
+}
+
+
+namespace sd
+{
+
+//==============================================================================
+
+/** @brief Generates BBCode corpora. The same kind, size and seed always give the same text. */
+class CorpusGenerator
+{
+public:
+    enum class Kind
+    {
+        plain,
+        nested,
+        colour,
+        font,
+        lists,
+        quotes
+    };
+
+    static constexpr std::array<Kind, 6> kKinds { Kind::plain, Kind::nested, Kind::colour, Kind::font, Kind::lists, Kind::quotes };
+
+    static const char* getName( Kind kind ) noexcept
+    {
+        switch( kind )
+        {
+            case Kind::plain: return "plain";
+            case Kind::nested: return "nested";
+            case Kind::colour: return "colour";
+            case Kind::font: return "font";
+            case Kind::lists: return "lists";
+            case Kind::quotes: return "quotes";
+            default: return "?";
+        }
+    }
+
+    static std::string generate( Kind kind, size_t numBytes, juce::int64 seed = 0x5d5d )
+    {
+        CorpusGenerator generator { seed + static_cast<juce::int64>( kind ) };
+        std::string     text;
+        text.reserve( numBytes + 256 );
+
+        while( text.size() < numBytes )
+            generator.addParagraph( kind, text );
+
+        return text;
+    }
+
+private:
+    static constexpr std::array<const char*, 16> kWords { "lorem", "ipsum", "dolor", "sit",    "amet",   "consectetur", "adipiscing", "elit",
+                                                          "sed",   "do",    "eiusmod", "tempor", "labore", "magna",       "aliqua",     "veniam" };
+    static constexpr std::array<const char*, 8>  kColours { "red", "green", "blue", "gold", "#ff8000", "#0af", "darkslategray", "#20c0e0ff" };
+    static constexpr std::array<const char*, 4>  kFonts { "Arial", "Courier New", "Times New Roman", "Verdana" };
+    static constexpr std::array<const char*, 5>  kStyles { "b", "i", "u", "size=18", "color=orange" };
+
+    juce::Random m_random;
+
+    explicit CorpusGenerator( juce::int64 seed ) : m_random( seed ) {}
+
+    template <size_t N>
+    const char* pick( const std::array<const char*, N>& items )
+    {
+        return items[static_cast<size_t>( m_random.nextInt( static_cast<int>( N ) ) )];
+    }
+
+    void addWords( std::string& text, int numWords )
+    {
+        for( int word = 0; word < numWords; ++word )
+            text.append( pick( kWords ) ).append( " " );
+    }
+
+    void addParagraph( Kind kind, std::string& text )
+    {
+        switch( kind )
+        {
+            case Kind::plain: addWords( text, 12 ); break;
+
+            case Kind::nested:
+            {
+                const auto depth = 1 + m_random.nextInt( 12 );
+                for( int level = 0; level < depth; ++level )
+                {
+                    text.append( "[" ).append( kStyles[static_cast<size_t>( level ) % kStyles.size()] ).append( "]" );
+                    addWords( text, 1 );
+                }
+                for( int level = depth; --level >= 0; )
+                {
+                    const std::string_view style { kStyles[static_cast<size_t>( level ) % kStyles.size()] };
+                    text.append( "[/" ).append( style.substr( 0, style.find( '=' ) ) ).append( "]" );
+                    addWords( text, 1 );
+                }
+                break;
+            }
+
+            case Kind::colour:
+                for( int word = 0; word < 6; ++word )
+                {
+                    text.append( "[color=" ).append( pick( kColours ) ).append( "]" );
+                    addWords( text, 1 );
+                    text.append( "[/color] " );
+                }
+                break;
+
+            case Kind::font:
+                text.append( "[font=" ).append( pick( kFonts ) ).append( "]" );
+                addWords( text, 4 );
+                text.append( "[size=" ).append( std::to_string( 8 + m_random.nextInt( 30 ) ) ).append( "]" );
+                addWords( text, 3 );
+                text.append( "[/size][/font][code]" );
+                addWords( text, 3 );
+                text.append( "[/code]" );
+                break;
+
+            case Kind::lists:
+                for( int item = 0; item < 5; ++item )
+                {
+                    text.append( "[*]" );
+                    addWords( text, 4 );
+                    text.append( "\n" );
+                }
+                break;
+
+            case Kind::quotes:
+                text.append( "[quote=" ).append( pick( kWords ) ).append( "]" );
+                addWords( text, 10 );
+                text.append( "[/quote]" );
+                addWords( text, 3 );
+                break;
+
+            default: break;
+        }
+        text.append( "\n" );
+    }
+};
+//==============================================================================
+
+/** @brief Times a function over a number of iterations. */
+class Stopwatch
+{
+public:
+    struct Result
+    {
+        double       bestSeconds { 0.0 };
+        juce::uint64 numAllocations { 0 };  ///< Heap allocations of one iteration.
+    };
+
+    template <typename Function>
+    static Result measure( int numIterations, Function&& function )
+    {
+        return measure( numIterations, [] {}, std::forward<Function>( function ) );
+    }
+
+    /** Calls prepare before every iteration, without timing it. */
+    template <typename Prepare, typename Function>
+    static Result measure( int numIterations, Prepare&& prepare, Function&& function )
+    {
+        Result result { std::numeric_limits<double>::max(), 0 };
+
+        for( int iteration = 0; iteration < numIterations; ++iteration )
+        {
+            prepare();
+
+            const auto allocationsBefore = gNumAllocations.load( std::memory_order_relaxed );
+            const auto start             = std::chrono::steady_clock::now();
+
+            function();
+
+            const auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            result.bestSeconds = std::min( result.bestSeconds, seconds );
+            result.numAllocations = gNumAllocations.load( std::memory_order_relaxed ) - allocationsBefore;
+        }
+        return result;
+    }
+};
+//==============================================================================
+
+class Benchmark
+{
+public:
+    static constexpr size_t kDefaultMaxSize { 10 * 1024 * 1024 };
+    static constexpr size_t kDefaultEditorMaxSize { 1024 * 1024 };
+    static constexpr size_t kBytesPerMeasurement { 32 * 1024 * 1024 };  // Small corpora are run until this many bytes are processed.
+    static constexpr int    kMaxIterations { 1000 };
+
+    Benchmark( size_t maxSize, size_t editorMaxSize, bool csv ) : m_maxSize( maxSize ), m_editorMaxSize( editorMaxSize ), m_csv( csv ) {}
+
+    void run()
+    {
+        printHeader();
+
+        for( const auto kind : CorpusGenerator::kKinds )
+        {
+            for( const size_t size : { size_t { 1024 }, size_t { 16 * 1024 }, size_t { 256 * 1024 }, size_t { 1024 * 1024 }, size_t { 10 * 1024 * 1024 } } )
+            {
+                if( size > m_maxSize )
+                    break;
+
+                const auto corpus = CorpusGenerator::generate( kind, size );
+                runCorpus( CorpusGenerator::getName( kind ), corpus );
+            }
+        }
+    }
+
+private:
+    size_t m_maxSize;
+    size_t m_editorMaxSize;
+    bool   m_csv;
+
+    void runCorpus( const char* name, const std::string& corpus )
+    {
+        const std::string_view text { corpus };
+        const auto             numIterations = static_cast<int>( juce::jlimit( size_t { 1 }, size_t { kMaxIterations }, kBytesPerMeasurement / text.size() ) );
+
+        // Gather the tags up front, so only withToken is timed...
+        std::vector<std::string_view> tags;
+        std::vector<std::string_view> colourTags;
+        BBCodeTokenizer               tokenizer { text };
+        while( const auto token = tokenizer.next() )
+        {
+            if( token->type == BBCodeTokenizer::Token::Type::openTag || token->type == BBCodeTokenizer::Token::Type::closeTag )
+            {
+                tags.push_back( token->tag );
+                if( token->name == BBCode::kColourToken )
+                    colourTags.push_back( token->tag );
+            }
+        }
+
+        size_t numTokens { 0 };
+        report( name, text.size(), "tokenize", Stopwatch::measure( numIterations, [&] {
+                    numTokens = 0;
+                    BBCodeTokenizer scan { text };
+                    while( scan.next() )
+                        ++numTokens;
+                } ) );
+
+        report( name, text.size(), "withToken", Stopwatch::measure( numIterations, [&] { applyTokens( tags ); } ) );
+        report( name, text.size(), "colour", Stopwatch::measure( numIterations, [&] { applyTokens( colourTags ); } ) );
+
+        BBCodeParser parser;
+        report( name, text.size(), "parse", Stopwatch::measure( numIterations, [&] { juce::ignoreUnused( parser.parse( text ) ); } ) );
+
+        if( text.size() <= m_editorMaxSize )
+        {
+            const auto bbText = juce::String::fromUTF8( text.data(), static_cast<int>( text.size() ) );
+
+            const auto numEditorIterations = std::max( 1, numIterations / 10 );
+
+            BBCodeEditor editor;
+            editor.setMultiLine( true );
+            editor.setSize( 800, 600 );
+
+            // Empty the editor first, or setBBText would find the text unchanged and only render its end again...
+            report( name, text.size(), "setBBText", Stopwatch::measure( numEditorIterations, [&] { editor.setBBDocument( {} ); }, [&] { editor.setBBText( bbText ); } ) );
+
+            // An edit at the start of the last line, as when a status or log line changes...
+            const auto lastLine = bbText.dropLastCharacters( 1 ).lastIndexOfChar( '\n' ) + 1;
+            const auto edited   = bbText.substring( 0, lastLine ) + "[b]edited[/b] " + bbText.substring( lastLine );
+            report( name, text.size(), "editTail", Stopwatch::measure( numEditorIterations, [&] { editor.setBBText( bbText ); }, [&] { editor.setBBText( edited ); } ) );
+        }
+    }
+
+    static void applyTokens( const std::vector<std::string_view>& tags )
+    {
+        TextFormatState state;
+        for( const auto& tag : tags )
+            if( const auto newState = state.withToken( tag ) )
+                state = *newState;
+    }
+
+    void printHeader() const
+    {
+        if( m_csv )
+            std::printf( "corpus,bytes,phase,ns_per_byte,mb_per_s,allocations\n" );
+        else
+            std::printf( "%-8s %10s  %-10s %12s %10s %12s\n", "corpus", "bytes", "phase", "ns/byte", "MB/s", "allocations" );
+    }
+
+    void report( const char* name, size_t numBytes, const char* phase, const Stopwatch::Result& result ) const
+    {
+        const auto nsPerByte = result.bestSeconds * 1.0e9 / static_cast<double>( numBytes );
+        const auto mbPerSec  = static_cast<double>( numBytes ) / ( 1024.0 * 1024.0 ) / std::max( result.bestSeconds, 1.0e-12 );
+
+        if( m_csv )
+            std::printf( "%s,%zu,%s,%.3f,%.1f,%llu\n", name, numBytes, phase, nsPerByte, mbPerSec, static_cast<unsigned long long>( result.numAllocations ) );
+        else
+            std::printf( "%-8s %10zu  %-10s %12.3f %10.1f %12llu\n", name, numBytes, phase, nsPerByte, mbPerSec, static_cast<unsigned long long>( result.numAllocations ) );
+
+        std::fflush( stdout );
+    }
+};
+
+}  // namespace sd
+//==============================================================================
+
+int main( int argc, char* argv[] )
+{
+    auto maxSize       = sd::Benchmark::kDefaultMaxSize;
+    auto editorMaxSize = sd::Benchmark::kDefaultEditorMaxSize;
+    bool csv           = false;
+
+    for( int index = 1; index < argc; ++index )
+    {
+        const std::string_view argument { argv[index] };
+
+        if( argument == "--csv" )
+            csv = true;
+        else if( argument == "--max-size" && index + 1 < argc )
+            maxSize = std::strtoull( argv[++index], nullptr, 10 );
+        else if( argument == "--editor-max-size" && index + 1 < argc )
+            editorMaxSize = std::strtoull( argv[++index], nullptr, 10 );
+        else
+        {
+            std::printf( "Usage: %s [--max-size <bytes>] [--editor-max-size <bytes>] [--csv]\n", argv[0] );
+            return 1;
+        }
+    }
+
+    // The editor is never put on the desktop, so no display is needed...
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // Enumerate the system fonts before anything is timed...
+    juce::ignoreUnused( sd::TypefaceNameCache::getInstance().resolve( "Arial" ) );
+
+    sd::Benchmark { maxSize, editorMaxSize, csv }.run();
+    return 0;
+}
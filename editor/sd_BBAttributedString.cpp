@@ -0,0 +1,64 @@
+/*
+  =====================================================================================================
+
+    sd_BBAttributedString.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+juce::AttributedString createAttributedString( const juce::String& bbText, const juce::Colour& defaultColour )
+{
+    BBCodeParser parser { defaultColour };
+    return createAttributedString( parser.parse( bbText ) );
+}
+//==============================================================================
+
+juce::AttributedString createAttributedString( const BBDocument& document )
+{
+    juce::AttributedString string;
+    string.setWordWrap( juce::AttributedString::byWord );
+    string.setJustification( document.getJustification() );
+    appendToAttributedString( string, document );
+    return string;
+}
+//==============================================================================
+
+void appendToAttributedString( juce::AttributedString& string, const BBDocument& document, size_t textStart, size_t textEnd )
+{
+    const auto& runs = document.getRuns();
+    textEnd          = std::min( textEnd, document.getText().size() );
+
+    // Skip the runs that end before the start...
+    auto run = std::partition_point( runs.begin(), runs.end(), [textStart]( const BBDocument::Run& candidate ) {
+        return size_t { candidate.offset } + candidate.length <= textStart;
+    } );
+
+    while( run != runs.end() && run->offset < textEnd )
+    {
+        // Runs that only differ in their flags look the same...
+        auto last = std::next( run );
+        for( ; last != runs.end() && last->offset < textEnd && last->state == run->state; ++last )
+            ;
+
+        const auto  start = std::max( size_t { run->offset }, textStart );
+        const auto  end   = std::min( size_t { std::prev( last )->offset } + std::prev( last )->length, textEnd );
+        const auto& state = document.getState( *run );
+        string.append( BBCodeTokenizer::toString( document.getText().substr( start, end - start ) ), state.getFont(), state.getColour() );
+
+        run = last;
+    }
+}
+//==============================================================================
+
+}  // namespace sd
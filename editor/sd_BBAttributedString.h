@@ -0,0 +1,57 @@
+/*
+  =====================================================================================================
+
+    sd_BBAttributedString.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Convert BBCode formatted text to a juce::AttributedString.
+ *
+ * For tooltips, list rows and other places that only draw text: the result can be
+ * drawn with juce::TextLayout in any paint() without creating a component.
+ * Bullets, quotes and code blocks look the same as in BBCodeEditor.
+ *
+ * @param bbText        The BBCode formatted text.
+ * @param defaultColour The colour of text without [color] tag.
+ * @return              The formatted text, justified by the last [align] tag.
+ *
+ * @see BBCodeEditor::setBBText
+ */
+[[nodiscard]] juce::AttributedString createAttributedString( const juce::String& bbText,
+                                                             const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour } );
+
+/**
+ * @brief Convert a parsed document to a juce::AttributedString.
+ *
+ * @param document The document, as parsed by BBCodeParser.
+ * @return         The formatted text, justified by the last [align] tag.
+ */
+[[nodiscard]] juce::AttributedString createAttributedString( const BBDocument& document );
+
+/**
+ * @brief Append part of a parsed document to a juce::AttributedString.
+ *
+ * Only appends text with its font and colour, justification and word wrap are left alone.
+ *
+ * @param string    The string to append to.
+ * @param document  The document, as parsed by BBCodeParser.
+ * @param textStart Offset in bytes into the document text of the first character to append.
+ * @param textEnd   Offset in bytes into the document text past the last character to append.
+ */
+void appendToAttributedString( juce::AttributedString& string, const BBDocument& document, size_t textStart = 0,
+                               size_t textEnd = std::string_view::npos );
+
+}  // namespace sd
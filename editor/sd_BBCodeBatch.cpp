@@ -0,0 +1,101 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeBatch.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+namespace
+{
+
+//==============================================================================
+
+/**
+ * Runs the work function on the calling thread and on up to numItems - 1 pool threads.
+ * Every call takes items until none are left, so fast threads take over from slow ones.
+ */
+void runInParallel( size_t numItems, juce::ThreadPool* threadPool, const std::function<void()>& work )
+{
+    std::unique_ptr<juce::ThreadPool> temporaryPool;
+    if( threadPool == nullptr && numItems > 1 )
+    {
+        temporaryPool = std::make_unique<juce::ThreadPool>( std::max( 1, juce::SystemStats::getNumCpus() - 1 ) );
+        threadPool    = temporaryPool.get();
+    }
+
+    const auto numJobs = threadPool != nullptr && numItems > 1 ? std::min( static_cast<size_t>( threadPool->getNumThreads() ), numItems - 1 ) : size_t { 0 };
+
+    // Jobs that start after the calling thread took the last item still call the work function, so wait for all of them.
+    // The jobs share ownership of the event, it may still be signalling when this returns...
+    struct Completion
+    {
+        std::atomic<size_t> numRunning;
+        juce::WaitableEvent finished;
+    };
+    const auto completion = std::make_shared<Completion>();
+    completion->numRunning = numJobs;
+
+    for( size_t job = 0; job < numJobs; ++job )
+    {
+        threadPool->addJob( [&work, completion] {
+            work();
+            if( --completion->numRunning == 0 )
+                completion->finished.signal();
+        } );
+    }
+
+    work();
+
+    if( numJobs > 0 )
+        completion->finished.wait();
+}
+//==============================================================================
+
+}  // namespace
+
+//==============================================================================
+
+std::vector<BBDocument> parseInParallel( const juce::StringArray& bbTexts, const juce::Colour& defaultColour, juce::ThreadPool* threadPool )
+{
+    const auto              numTexts = static_cast<size_t>( bbTexts.size() );
+    std::vector<BBDocument> documents( numTexts );
+    std::atomic<size_t>     next { 0 };
+
+    runInParallel( numTexts, threadPool, [&] {
+        BBCodeParser parser { defaultColour };
+        for( auto index = next++; index < numTexts; index = next++ )
+            documents[index] = parser.parse( bbTexts[static_cast<int>( index )] );
+    } );
+
+    return documents;
+}
+//==============================================================================
+
+std::vector<juce::AttributedString> createAttributedStringsInParallel( const juce::StringArray& bbTexts, const juce::Colour& defaultColour,
+                                                                      juce::ThreadPool* threadPool )
+{
+    const auto                          numTexts = static_cast<size_t>( bbTexts.size() );
+    std::vector<juce::AttributedString> strings( numTexts );
+    std::atomic<size_t>                 next { 0 };
+
+    runInParallel( numTexts, threadPool, [&] {
+        BBCodeParser parser { defaultColour };
+        for( auto index = next++; index < numTexts; index = next++ )
+            strings[index] = createAttributedString( parser.parse( bbTexts[static_cast<int>( index )] ) );
+    } );
+
+    return strings;
+}
+//==============================================================================
+
+}  // namespace sd
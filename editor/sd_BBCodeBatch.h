@@ -0,0 +1,45 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeBatch.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Parse many BBCode texts in parallel.
+ *
+ * The texts are divided over the threads of the pool and the calling thread,
+ * which each parse with their own BBCodeParser. Returns when all are done.
+ * Must not be called from a job running on the same pool.
+ *
+ * @param bbTexts       The BBCode formatted texts.
+ * @param defaultColour The colour of text without [color] tag.
+ * @param threadPool    The pool to use, or nullptr to use a temporary pool with a thread per CPU.
+ * @return              The parsed documents, in the order of the texts.
+ */
+[[nodiscard]] std::vector<BBDocument> parseInParallel( const juce::StringArray& bbTexts,
+                                                       const juce::Colour&      defaultColour = juce::Colour { TextFormatState::kDefaultColour },
+                                                       juce::ThreadPool*        threadPool    = nullptr );
+
+/**
+ * @brief Convert many BBCode texts to juce::AttributedString in parallel.
+ *
+ * @see parseInParallel, createAttributedString
+ */
+[[nodiscard]] std::vector<juce::AttributedString> createAttributedStringsInParallel( const juce::StringArray& bbTexts,
+                                                                                    const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour },
+                                                                                    juce::ThreadPool*   threadPool    = nullptr );
+
+}  // namespace sd
@@ -0,0 +1,407 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeParser.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+namespace sd
+{
+
+void BBCodeParser::reset( const juce::Colour& defaultColour )
+{
+    m_defaultColour = defaultColour;
+    m_listPrefix    = false;
+    m_quotePrefix   = false;
+    m_alignment     = BBDocument::Alignment::left;
+    m_states.clear();
+    m_stateDepth    = 0;
+    m_numOverflowed = 0;
+    pushState( TextFormatState { m_defaultColour } );
+    BBCODE_STATS( m_stats = {}; )
+}
+//==============================================================================
+
+BBDocument BBCodeParser::parse( const juce::String& bbText )
+{
+    return parse( std::string_view { bbText.toRawUTF8(), bbText.getNumBytesAsUTF8() } );
+}
+//==============================================================================
+
+void BBCodeParser::restore( const Checkpoint& checkpoint )
+{
+    jassert( !checkpoint.stateQueue.empty() && checkpoint.stateQueue.size() <= kMaxStateDepth );
+
+    m_states.clear();
+    m_stateDepth = 0;
+    for( const auto& state : checkpoint.stateQueue )
+        pushState( state );
+
+    m_numOverflowed = checkpoint.numOverflowed;
+    m_listPrefix    = checkpoint.listPrefix;
+    m_quotePrefix   = checkpoint.quotePrefix;
+    m_alignment     = checkpoint.alignment;
+    BBCODE_STATS( m_stats = {}; )
+}
+//==============================================================================
+
+BBCodeParser::Checkpoint BBCodeParser::getCheckpoint() const
+{
+    return { 0, 0, 0, getStateStack(), m_listPrefix, m_quotePrefix, m_alignment, m_numOverflowed };
+}
+//==============================================================================
+
+BBDocument BBCodeParser::parse( std::string_view bbText )
+{
+    reset( m_defaultColour );
+    return parseNext( bbText );
+}
+//==============================================================================
+
+/** Builds the BBDocument of parseNext. */
+class BBCodeParser::DocumentSink final : public BBCodeParser::Sink
+{
+public:
+    DocumentSink( BBCodeParser& parser, BBDocument& document, std::vector<Checkpoint>* checkpoints ) noexcept
+        : m_parser( parser ), m_document( document ), m_checkpoints( checkpoints )
+    {
+    }
+
+    void addRun( juce::uint16 state, juce::uint8 flags, std::initializer_list<std::string_view> text, [[maybe_unused]] size_t tokenOffset ) override
+    {
+        const auto documentState = m_parser.intern( m_document, state );
+        const auto alignment     = m_parser.m_alignment;
+
+        // Text in the same format continues the previous run, e.g. after [b][/b] or an unknown tag.
+        // Runs before a checkpoint stay as they are, so its run index keeps pointing at its text...
+        if( m_document.m_runs.size() > m_firstMergeableRun )
+        {
+            auto& previous = m_document.m_runs.back();
+            if( previous.state == documentState && previous.flags == flags && previous.alignment == alignment )
+            {
+                BBCODE_STATS( const auto textCapacity = m_document.m_text.capacity(); )
+
+                for( const auto& part : text )
+                    m_document.m_text.append( part );
+                previous.length = static_cast<juce::uint32>( m_document.m_text.size() - previous.offset );
+
+                BBCODE_STATS( ++m_parser.m_stats.numMergedRuns; m_parser.m_stats.numAllocations += m_document.m_text.capacity() != textCapacity ? 1 : 0; )
+                return;
+            }
+        }
+
+        BBDocument::Run run;
+        run.offset    = static_cast<juce::uint32>( m_document.m_text.size() );
+        run.state     = documentState;
+        run.flags     = flags;
+        run.alignment = alignment;
+
+        BBCODE_STATS( const auto textCapacity = m_document.m_text.capacity(); const auto runCapacity = m_document.m_runs.capacity(); )
+
+        for( const auto& part : text )
+            m_document.m_text.append( part );
+
+        run.length = static_cast<juce::uint32>( m_document.m_text.size() - run.offset );
+        m_document.m_runs.push_back( run );
+
+        BBCODE_STATS( m_parser.m_stats.numAllocations += ( m_document.m_text.capacity() != textCapacity ? 1 : 0 ) + ( m_document.m_runs.capacity() != runCapacity ? 1 : 0 ); )
+    }
+
+    void addCheckpoint( size_t sourceOffset, size_t sourceDependency ) override
+    {
+        if( m_checkpoints == nullptr )
+            return;
+
+        auto checkpoint             = m_parser.getCheckpoint();
+        checkpoint.sourceOffset     = sourceOffset;
+        checkpoint.sourceDependency = sourceDependency;
+        checkpoint.runIndex         = m_document.m_runs.size();
+        m_checkpoints->push_back( std::move( checkpoint ) );
+        m_firstMergeableRun = m_document.m_runs.size();
+    }
+
+private:
+    BBCodeParser&            m_parser;
+    BBDocument&              m_document;
+    std::vector<Checkpoint>* m_checkpoints;
+    size_t                   m_firstMergeableRun { 0 };  // Runs before this one are not extended.
+};
+//==============================================================================
+
+BBDocument BBCodeParser::parseNext( std::string_view bbText, std::vector<Checkpoint>* checkpoints )
+{
+    if( m_stateDepth == 0 )
+        reset( m_defaultColour );
+    else
+        compactStates();
+
+    BBCODE_STATS( m_stats = {}; m_stats.numBytes = bbText.size(); m_stats.maxStateDepth = m_stateDepth + m_numOverflowed; )
+    BBCODE_STATS( const auto parseStart = juce::Time::getHighResolutionTicks(); )
+
+    // Most tags start one run, and tags take more room than the text they add...
+    BBDocument document;
+    document.m_text.reserve( bbText.size() );
+    document.m_runs.reserve( estimateNumRuns( bbText ) );
+    BBCODE_STATS( m_stats.numAllocations += bbText.empty() ? 0 : 2; )
+    m_documentStates.assign( m_states.getNumStates(), FormatStateTable::kNoState );
+
+    DocumentSink sink { *this, document, checkpoints };
+    parseTokens( bbText, sink );
+
+    document.m_alignment = m_alignment;
+
+#if BBCODE_EDITOR_ENABLE_STATS
+    m_stats.numRuns        = document.m_runs.size();
+    m_stats.resolveSeconds = juce::Time::highResolutionTicksToSeconds( juce::Time::getHighResolutionTicks() - parseStart ) - m_stats.tokenizeSeconds;
+#endif
+
+    return document;
+}
+//==============================================================================
+
+void BBCodeParser::parseNext( std::string_view bbText, Sink& sink )
+{
+    if( m_stateDepth == 0 )
+        reset( m_defaultColour );
+    else
+        compactStates();
+
+    BBCODE_STATS( m_stats = {}; m_stats.numBytes = bbText.size(); m_stats.maxStateDepth = m_stateDepth + m_numOverflowed; )
+
+    parseTokens( bbText, sink );
+}
+//==============================================================================
+
+void BBCodeParser::parseTokens( std::string_view bbText, Sink& sink )
+{
+    using Token = BBCodeTokenizer::Token;
+
+    BBCodeTokenizer tokenizer { bbText };
+#if BBCODE_EDITOR_ENABLE_STATS
+    const auto nextToken = [this, &tokenizer] {
+        const ParseStats::ScopedTimer timer { m_stats.tokenizeSeconds };
+        return tokenizer.next();
+    };
+#else
+    const auto nextToken = [&tokenizer] { return tokenizer.next(); };
+#endif
+
+    size_t lastCheckpoint { 0 };
+    size_t scanEnd { 0 };  // How far the tokens before the current one looked.
+    while( const auto token = nextToken() )
+    {
+        const auto offset = static_cast<size_t>( token->source.data() - bbText.data() );
+        if( offset >= lastCheckpoint + kCheckpointInterval )
+        {
+            sink.addCheckpoint( offset, scanEnd );
+            lastCheckpoint = offset;
+        }
+        scanEnd = tokenizer.getScanEnd();
+
+        BBCODE_STATS( ++m_stats.numTokens; )
+
+        if( token->type == Token::Type::text )
+        {
+            addText( sink, token->text, {}, BBDocument::plain, offset );
+            continue;
+        }
+
+        // Check for 'quote' tokens...
+        std::string_view value {};
+        if( BBCodeTokenizer::startsWith( token->tag, BBCode::kQuoteToken ) )
+        {
+            value         = token->value;
+            m_quotePrefix = true;
+        }
+
+        // Only opening tags resolve a typeface, closing ones look for one resolved before...
+        BBCODE_STATS( if( token->type == Token::Type::openTag && !token->malformed && isTypefaceTag( token->name ) ) ++m_stats.numTypefaceLookups; )
+
+        // Process lists...
+        bool succesfullyParsed = true;
+        if( token->type == Token::Type::bullet )
+        {
+            m_listPrefix = true;
+        }
+        else if( token->malformed )
+        {
+            succesfullyParsed = false;
+            BBCODE_STATS( ++m_stats.numMalformedTags; )
+        }
+        // Parse justification (juce::TextEditor only has global justification)...
+        else if( BBCodeTokenizer::startsWith( token->tag, BBCode::kAlignToken ) )
+        {
+            m_alignment = parseAlignment( token->tag );
+        }
+        // Parse other tokens...
+        else if( auto newState = m_states.getState( m_stateStack[m_stateDepth - 1] )
+                                     .withTag( token->name, token->value, token->type != Token::Type::closeTag ) )
+        {
+            // End token pops state...
+            if( token->type == Token::Type::closeTag )
+            {
+                if( m_numOverflowed > 0 )
+                    --m_numOverflowed;
+                else if( m_stateDepth > 1 )
+                    --m_stateDepth;
+            }
+            // Start token pushes state...
+            else
+            {
+                pushState( *newState );
+                BBCODE_STATS( m_stats.maxStateDepth = std::max( m_stats.maxStateDepth, m_stateDepth + m_numOverflowed ); )
+            }
+        }
+        else
+        {
+            succesfullyParsed = false;
+            BBCODE_STATS( ++m_stats.numUnknownTags; )
+        }
+
+        // Padding for CODE blocks...
+        const auto isCode = BBCodeTokenizer::startsWith( token->tag, BBCode::kCodeToken );
+        addText( sink, succesfullyParsed ? token->text : token->source, value, isCode ? BBDocument::code : BBDocument::plain, offset );
+    }
+}
+//==============================================================================
+
+void BBCodeParser::pushState( const TextFormatState& state )
+{
+    const auto index = m_states.intern( state );
+    jassert( index != FormatStateTable::kNoState );
+
+    // Too deep, or too many different states: keep the current format...
+    if( m_stateDepth == kMaxStateDepth || index == FormatStateTable::kNoState )
+    {
+        BBCODE_STATS( ++m_stats.numOverflowedTags; )
+        ++m_numOverflowed;
+        return;
+    }
+
+    m_stateStack[m_stateDepth++] = index;
+}
+//==============================================================================
+
+void BBCodeParser::compactStates()
+{
+    // Only the open states carry over to the next call, as in restore(). Otherwise the table
+    // keeps growing with every chunk of appended or streamed text, until tags stop formatting...
+    if( m_states.getNumStates() <= m_stateDepth )
+        return;
+
+    std::array<TextFormatState, kMaxStateDepth> openStates {};
+    const auto                                  depth = m_stateDepth;
+    for( size_t index = 0; index < depth; ++index )
+        openStates[index] = m_states.getState( m_stateStack[index] );
+
+    m_states.clear();
+    m_stateDepth = 0;
+    for( size_t index = 0; index < depth; ++index )
+        pushState( openStates[index] );
+}
+//==============================================================================
+
+std::vector<TextFormatState> BBCodeParser::getStateStack() const
+{
+    std::vector<TextFormatState> states;
+    states.reserve( m_stateDepth );
+    for( size_t depth = 0; depth < m_stateDepth; ++depth )
+        states.push_back( m_states.getState( m_stateStack[depth] ) );
+    return states;
+}
+//==============================================================================
+
+void BBCodeParser::addText( Sink& sink, std::string_view text, std::string_view value, juce::uint8 flags, size_t tokenOffset )
+{
+    // Code blocks are padded, so they always have text...
+    const auto isCode = ( flags & BBDocument::code ) != 0;
+    if( text.empty() && !isCode )
+        return;
+
+    const std::string_view lineBreak { isCode ? BBCode::kNewLine : "" };
+    const std::string_view indent { isCode ? BBCode::kTabCharacter : "" };
+    const auto             state = m_stateStack[m_stateDepth - 1];
+
+    // Add quote...
+    if( m_quotePrefix )
+    {
+        flags |= BBDocument::quote;
+
+        sink.addRun( state, flags, { BBCode::kNewLine, BBCode::kNewLine, "|", BBCode::kTabCharacter }, tokenOffset );
+        if( !value.empty() )
+        {
+            // The header is always bold...
+            const auto boldState = m_states.getState( state ).withToken( std::string_view { BBCode::kBoldToken } );
+            const auto boldIndex = boldState ? m_states.intern( *boldState ) : FormatStateTable::kNoState;
+            sink.addRun( boldIndex != FormatStateTable::kNoState ? boldIndex : state, flags | BBDocument::quoteHeader, { value, ": " }, tokenOffset );
+        }
+        sink.addRun( state, flags, { BBCode::kOpenQuotes, lineBreak, lineBreak, indent, text, lineBreak, lineBreak, BBCode::kCloseQuotes }, tokenOffset );
+    }
+    // Add bullet list item...
+    else if( m_listPrefix )
+    {
+        sink.addRun( state, flags | BBDocument::listItem, { BBCode::kBulletCharacter, BBCode::kTabCharacter, lineBreak, lineBreak, indent, text, lineBreak, lineBreak }, tokenOffset );
+    }
+    // Add plain text...
+    else
+    {
+        sink.addRun( state, flags, { lineBreak, lineBreak, indent, text, lineBreak, lineBreak }, tokenOffset );
+    }
+    m_listPrefix  = false;
+    m_quotePrefix = false;
+}
+//==============================================================================
+
+juce::uint16 BBCodeParser::intern( BBDocument& document, juce::uint16 tableIndex )
+{
+    // States interned since this document started are not mapped yet...
+    if( tableIndex >= m_documentStates.size() )
+        m_documentStates.resize( m_states.getNumStates(), FormatStateTable::kNoState );
+
+    auto& documentIndex = m_documentStates[tableIndex];
+    if( documentIndex == FormatStateTable::kNoState )
+    {
+        BBCODE_STATS( m_stats.numAllocations += document.m_states.size() == document.m_states.capacity() ? 1 : 0; )
+        documentIndex = static_cast<juce::uint16>( document.m_states.size() );
+        document.m_states.push_back( m_states.getState( tableIndex ) );
+    }
+    return documentIndex;
+}
+//==============================================================================
+
+BBDocument::Alignment BBCodeParser::parseAlignment( std::string_view token ) noexcept
+{
+    const auto endsWith = [token]( std::string_view suffix ) noexcept {
+        return token.size() >= suffix.size() && compareIgnoreCase( suffix, token.substr( token.size() - suffix.size() ) ) == 0;
+    };
+
+    if( endsWith( "right" ) )
+        return BBDocument::Alignment::right;
+    if( endsWith( "center" ) )
+        return BBDocument::Alignment::centre;
+    if( endsWith( "justify" ) )
+        return BBDocument::Alignment::justify;
+
+    return BBDocument::Alignment::left;
+}
+//==============================================================================
+
+bool BBCodeParser::isTypefaceTag( std::string_view name ) noexcept
+{
+    return compareIgnoreCase( BBCode::kFontToken, name ) == 0 || compareIgnoreCase( BBCode::kCodeToken, name ) == 0;
+}
+//==============================================================================
+
+size_t BBCodeParser::estimateNumRuns( std::string_view bbText ) noexcept
+{
+    return static_cast<size_t>( std::count( bbText.begin(), bbText.end(), *BBCode::kTokenStart ) ) + 1;
+}
+//==============================================================================
+
+}  // namespace sd
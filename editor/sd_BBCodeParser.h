@@ -0,0 +1,204 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeParser.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Parses BBCode into a BBDocument.
+ *
+ * The parser does not touch any Component, so it can run on any thread.
+ * Tags the application adds are looked up in BBCodeTagRegistry, after the built-in ones.
+ *
+ * Format states are interned in a FormatStateTable, the stack of open tags
+ * only holds their indices. Every parse call starts the table over with the
+ * open states. Tags nested deeper than kMaxStateDepth are counted but do not
+ * change the format, as are tags beyond FormatStateTable::kMaxNumStates
+ * different states within one call.
+ *
+ * @see BBDocument, BBCodeEditor, BBCodeTagRegistry
+ */
+class BBCodeParser
+{
+public:
+    /** Minimum distance in bytes between two checkpoints. */
+    static constexpr size_t kCheckpointInterval { 1024 };
+
+    /** Maximum nesting of format tags, deeper tags are ignored until they are closed. */
+    static constexpr size_t kMaxStateDepth { 16 };
+
+    /**
+     * @brief Parser state at the start of a tag, from where parsing can resume.
+     *
+     * @see parseNext, restore
+     */
+    struct Checkpoint
+    {
+        size_t                       sourceOffset { 0 };      ///< Offset in bytes of the tag to resume from.
+        size_t                       sourceDependency { 0 };  ///< Everything before the checkpoint only depends on the bytes before this offset.
+        size_t                       runIndex { 0 };          ///< Number of runs in the document before the checkpoint.
+        std::vector<TextFormatState> stateQueue;                 ///< The open format states, the default state first.
+        bool                         listPrefix { false };
+        bool                         quotePrefix { false };
+        BBDocument::Alignment        alignment { BBDocument::Alignment::left };
+        size_t                       numOverflowed { 0 };  ///< Open tags beyond kMaxStateDepth.
+    };
+
+    /**
+     * @brief Receives the runs of a parse.
+     *
+     * parseNext builds a BBDocument through one, createPlainText only collects the text.
+     *
+     * @see parseNext(std::string_view,Sink&)
+     */
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        /**
+         * @brief Add text in one format.
+         *
+         * @param state       The format state, see getState.
+         * @param flags       BBDocument::RunFlags.
+         * @param text        The text, in parts. Parts that lie inside the parsed text are copied from it, the
+         *                    others (bullets, quote marks, code block padding) are added by the token at tokenOffset.
+         * @param tokenOffset Offset in bytes into the parsed text of the token the run belongs to.
+         */
+        virtual void addRun( juce::uint16 state, juce::uint8 flags, std::initializer_list<std::string_view> text, size_t tokenOffset ) = 0;
+
+        /**
+         * @brief Called about every kCheckpointInterval bytes, at the start of a tag.
+         *
+         * @param sourceOffset     Offset in bytes into the parsed text of the tag.
+         * @param sourceDependency Everything before the tag only depends on the bytes before this offset.
+         *
+         * @see Checkpoint, getCheckpoint
+         */
+        virtual void addCheckpoint( [[maybe_unused]] size_t sourceOffset, [[maybe_unused]] size_t sourceDependency ) {}
+    };
+
+    explicit BBCodeParser( const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour } ) : m_defaultColour( defaultColour ) {}
+    BBCodeParser( BBCodeParser&& ) = default;
+    BBCodeParser& operator=( BBCodeParser&& ) = default;
+
+    /**
+     * @brief Parse BBCode formatted text.
+     *
+     * Starts from scratch: anything parsed before is forgotten.
+     *
+     * @param bbText The BBCode formatted text.
+     * @return       The parsed document.
+     *
+     * @see parseNext
+     */
+    [[nodiscard]] BBDocument parse( const juce::String& bbText );
+
+    /** @copydoc parse(const juce::String&) */
+    [[nodiscard]] BBDocument parse( std::string_view bbText );
+
+    /**
+     * @brief Parse text that follows the text parsed so far.
+     *
+     * Tags left open, pending list/quote prefixes and alignment carry over
+     * from the previous parse calls. Every chunk is tokenized on its own,
+     * so a tag can not be split between two chunks.
+     *
+     * Optionally records checkpoints, about every kCheckpointInterval bytes. After
+     * restoring one, parsing the text from its sourceOffset on continues exactly
+     * where the checkpoint was taken. Checkpoints are taken at the same offsets
+     * for the same text, whether parsing started at its beginning or at a checkpoint.
+     *
+     * @param bbText      The BBCode formatted text.
+     * @param checkpoints If not nullptr, checkpoints are added to it. Offsets are relative to bbText.
+     * @return            The document holding only the new text.
+     *
+     * @see parse, restore
+     */
+    [[nodiscard]] BBDocument parseNext( std::string_view bbText, std::vector<Checkpoint>* checkpoints = nullptr );
+
+    /**
+     * @brief Parse text that follows the text parsed so far, handing its runs to a sink.
+     *
+     * Same as parseNext above, but nothing is stored: the sink decides what to keep.
+     *
+     * @param bbText The BBCode formatted text.
+     * @param sink   Receives the runs, in order.
+     */
+    void parseNext( std::string_view bbText, Sink& sink );
+
+    /** @brief Get a format state handed to a Sink. It stays valid until the next parse, reset or restore. */
+    [[nodiscard]] const TextFormatState& getState( juce::uint16 state ) const noexcept { return m_states.getState( state ); }
+
+    /**
+     * @brief Forget everything parsed so far.
+     *
+     * @param defaultColour The colour of text without [color] tag.
+     */
+    void reset( const juce::Colour& defaultColour );
+
+    /**
+     * @brief Continue from a checkpoint.
+     *
+     * The default colour must be the one the checkpoint was parsed with.
+     *
+     * @param checkpoint The checkpoint, as recorded by parseNext.
+     */
+    void restore( const Checkpoint& checkpoint );
+
+    /**
+     * @brief Get the current state as a checkpoint.
+     *
+     * Only the state is set, the offsets and run index are zero.
+     *
+     * @see restore
+     */
+    [[nodiscard]] Checkpoint getCheckpoint() const;
+
+#if BBCODE_EDITOR_ENABLE_STATS
+    /** @brief Get the statistics of the last parse or parseNext call. Commit time and font lookups are not set. */
+    [[nodiscard]] const ParseStats& getLastParseStats() const noexcept { return m_stats; }
+#endif
+
+private:
+    juce::Colour                             m_defaultColour;
+    FormatStateTable                         m_states;  // The states open at the start of this parse call, and all states since.
+    std::array<juce::uint16, kMaxStateDepth> m_stateStack {};
+    size_t                                   m_stateDepth { 0 };
+    size_t                                   m_numOverflowed { 0 };      // Open tags beyond kMaxStateDepth.
+    std::vector<juce::uint16>                m_documentStates;  // Index in the current document of every table state, or kNoState.
+    bool                                     m_listPrefix { false };
+    bool                                     m_quotePrefix { false };
+    BBDocument::Alignment                    m_alignment { BBDocument::Alignment::left };
+    BBCODE_STATS( ParseStats m_stats; )
+
+    class DocumentSink;
+
+    void                         parseTokens( std::string_view bbText, Sink& sink );
+    void                         pushState( const TextFormatState& state );
+    void                         compactStates();
+    std::vector<TextFormatState> getStateStack() const;
+    void                         addText( Sink& sink, std::string_view text, std::string_view value, juce::uint8 flags, size_t tokenOffset );
+    juce::uint16                 intern( BBDocument& document, juce::uint16 tableIndex );
+
+    static BBDocument::Alignment parseAlignment( std::string_view token ) noexcept;
+    static bool                  isTypefaceTag( std::string_view name ) noexcept;
+    static size_t                estimateNumRuns( std::string_view bbText ) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBCodeParser )
+};
+
+}  // namespace sd
@@ -0,0 +1,151 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeStreamParser.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+namespace sd
+{
+
+BBCodeStreamParser::BBCodeStreamParser( const juce::Colour& defaultColour, size_t chunkSize )
+  : m_parser( defaultColour )
+  , m_defaultColour( defaultColour )
+  , m_chunkSize( std::max( chunkSize, kMinChunkSize ) )
+{
+    reset();
+}
+//==============================================================================
+
+void BBCodeStreamParser::parse( juce::InputStream& stream, const RunSink& sink )
+{
+    reset();
+
+    juce::HeapBlock<char> buffer( m_chunkSize );
+    while( !stream.isExhausted() )
+    {
+        const auto numRead = stream.read( buffer.get(), static_cast<int>( m_chunkSize ) );
+        if( numRead <= 0 )
+            break;
+
+        write( { buffer.get(), static_cast<size_t>( numRead ) }, sink );
+    }
+
+    finish( sink );
+}
+//==============================================================================
+
+void BBCodeStreamParser::parse( const juce::MemoryMappedFile& file, const RunSink& sink )
+{
+    reset();
+
+    if( file.getData() != nullptr )
+        write( { static_cast<const char*>( file.getData() ), file.getSize() }, sink );
+
+    finish( sink );
+}
+//==============================================================================
+
+void BBCodeStreamParser::write( std::string_view bbText, const RunSink& sink )
+{
+    while( !bbText.empty() )
+    {
+        // Whole chunks are parsed in place...
+        if( m_pending.empty() && bbText.size() >= m_chunkSize )
+        {
+            bbText.remove_prefix( parseAvailable( bbText.substr( 0, m_chunkSize ), sink ) );
+            continue;
+        }
+
+        // ...the rest is collected until it makes a chunk.
+        const auto numBytes = std::min( bbText.size(), m_chunkSize - m_pending.size() );
+        m_pending.append( bbText.substr( 0, numBytes ) );
+        bbText.remove_prefix( numBytes );
+
+        if( m_pending.size() == m_chunkSize )
+            m_pending.erase( 0, parseAvailable( m_pending, sink ) );
+    }
+}
+//==============================================================================
+
+void BBCodeStreamParser::finish( const RunSink& sink )
+{
+    const auto document = m_parser.parseNext( m_pending );
+    emit( document, document.getNumRuns(), sink );
+    reset();
+}
+//==============================================================================
+
+void BBCodeStreamParser::reset()
+{
+    m_parser.reset( m_defaultColour );
+    m_pending.clear();
+    m_checkpoints.clear();
+}
+//==============================================================================
+
+size_t BBCodeStreamParser::parseAvailable( std::string_view bbText, const RunSink& sink )
+{
+    jassert( !bbText.empty() );
+
+    const auto start = m_parser.getCheckpoint();
+    m_checkpoints.clear();
+    const auto document = m_parser.parseNext( bbText, &m_checkpoints );
+
+    // Continue from the last tag that did not need the text after this chunk...
+    for( auto checkpoint = m_checkpoints.crbegin(); checkpoint != m_checkpoints.crend(); ++checkpoint )
+    {
+        if( checkpoint->sourceDependency <= bbText.size() )
+        {
+            emit( document, checkpoint->runIndex, sink );
+            m_parser.restore( *checkpoint );
+            return checkpoint->sourceOffset;
+        }
+    }
+
+    // No tag to continue from, cut the text instead...
+    const auto cut = findCut( bbText );
+    m_parser.restore( start );
+    const auto head = m_parser.parseNext( bbText.substr( 0, cut ) );
+    emit( head, head.getNumRuns(), sink );
+    return cut;
+}
+//==============================================================================
+
+void BBCodeStreamParser::emit( const BBDocument& document, size_t numRuns, const RunSink& sink )
+{
+    for( size_t index = 0; index < numRuns; ++index )
+        sink( document, document.getRun( index ) );
+}
+//==============================================================================
+
+size_t BBCodeStreamParser::findCut( std::string_view bbText ) noexcept
+{
+    // Keep a tag that is not closed yet for the next chunk...
+    const auto tagStart = bbText.rfind( *BBCode::kTokenStart );
+    if( tagStart != std::string_view::npos && tagStart > 0 && bbText.find( *BBCode::kTokenEnd, tagStart ) == std::string_view::npos )
+        return tagStart;
+
+    // ...and do not cut a UTF-8 character in two.
+    const auto isContinuation = []( char byte ) noexcept { return ( static_cast<juce::uint8>( byte ) & 0xc0 ) == 0x80; };
+
+    auto lastStart = bbText.size();
+    while( lastStart > 0 && bbText.size() - lastStart < 4 )
+    {
+        if( !isContinuation( bbText[--lastStart] ) )
+            break;
+    }
+
+    const auto lead     = static_cast<juce::uint8>( bbText[lastStart] );
+    const auto numBytes = lead >= 0xf0 ? 4U : lead >= 0xe0 ? 3U : lead >= 0xc0 ? 2U : 1U;
+    return lastStart + numBytes > bbText.size() ? lastStart : bbText.size();
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,104 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeStreamParser.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Parses BBCode that is too large to hold in memory at once.
+ *
+ * The text is read in chunks and parsed as it comes in. Runs are handed to a
+ * sink as soon as they are complete, together with the chunk document holding
+ * their text and state. That document only lives for the duration of the call.
+ *
+ * A tag split between two chunks is kept until the rest of it has been read:
+ * the parser continues from its last checkpoint (see BBCodeParser::parseNext)
+ * that did not depend on the end of the chunk. Memory is bounded by the chunk
+ * size, for the text and its document, plus the open tags of the parser.
+ *
+ * Text without tags is cut at the chunk size when no checkpoint comes along.
+ * When that text belongs to a [code], [quote] or [*] longer than a chunk, only
+ * its first part gets the code padding, quote marks or list item flag.
+ *
+ * @see BBCodeParser, BBCodeView
+ */
+class BBCodeStreamParser
+{
+public:
+    static constexpr size_t kDefaultChunkSize { 64 * 1024 };
+
+    /** Receives every run of the text, in order. */
+    using RunSink = std::function<void( const BBDocument& document, const BBDocument::Run& run )>;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param defaultColour The colour of text without [color] tag.
+     * @param chunkSize     The number of bytes to read and parse at once, at least 4 KB.
+     */
+    explicit BBCodeStreamParser( const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour },
+                                 size_t              chunkSize     = kDefaultChunkSize );
+
+    /**
+     * @brief Parse the text of a stream, from its current position to its end.
+     *
+     * Starts from scratch: anything written before is forgotten.
+     */
+    void parse( juce::InputStream& stream, const RunSink& sink );
+
+    /**
+     * @brief Parse the text of a memory mapped file.
+     *
+     * The file is read in place, only the text of an incomplete tag is copied.
+     * Starts from scratch: anything written before is forgotten.
+     */
+    void parse( const juce::MemoryMappedFile& file, const RunSink& sink );
+
+    /**
+     * @brief Parse text that follows the text written so far.
+     *
+     * Text is parsed a chunk at a time. Runs that may still change are kept until
+     * more text is written or finish is called.
+     */
+    void write( std::string_view bbText, const RunSink& sink );
+
+    /** @brief Parse what is left of the text written, it is the end of the text. Then starts over. */
+    void finish( const RunSink& sink );
+
+    /** @brief Forget everything written so far. */
+    void reset();
+
+    /** @brief Get the number of bytes written that are not parsed yet. */
+    [[nodiscard]] size_t getNumPendingBytes() const noexcept { return m_pending.size(); }
+
+private:
+    static constexpr size_t kMinChunkSize { 4 * BBCodeParser::kCheckpointInterval };
+
+    BBCodeParser                          m_parser;
+    juce::Colour                          m_defaultColour;
+    size_t                                m_chunkSize;
+    std::string                           m_pending;  // Text written that is not parsed yet, less than a chunk.
+    std::vector<BBCodeParser::Checkpoint> m_checkpoints;
+
+    size_t parseAvailable( std::string_view bbText, const RunSink& sink );
+
+    static void   emit( const BBDocument& document, size_t numRuns, const RunSink& sink );
+    static size_t findCut( std::string_view bbText ) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBCodeStreamParser )
+};
+
+}  // namespace sd
@@ -0,0 +1,122 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeTagRegistry.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+namespace sd
+{
+
+namespace
+{
+
+bool isValidTagName( std::string_view name ) noexcept
+{
+    // The tokenizer would split the name, or take it for a closing tag or bullet...
+    return !name.empty() && name.find_first_of( "[]=" ) == std::string_view::npos && name.front() != *BBCode::kCloseTokenPrefix
+           && name.front() != *BBCode::kBulletToken;
+}
+//==============================================================================
+
+bool isBuiltInTagName( std::string_view name ) noexcept
+{
+    // The parser takes every tag starting with these for the built-in one...
+    for( const std::string_view prefix : { BBCode::kCodeToken, BBCode::kQuoteToken, BBCode::kAlignToken } )
+        if( compareIgnoreCase( prefix, name.substr( 0, prefix.size() ) ) == 0 )
+            return true;
+
+    for( const std::string_view tagName :
+         { BBCode::kBoldToken, BBCode::kItalicToken, BBCode::kUnderlineToken, BBCode::kSizeToken, BBCode::kColourToken, BBCode::kFontToken } )
+        if( compareIgnoreCase( tagName, name ) == 0 )
+            return true;
+
+    return false;
+}
+//==============================================================================
+
+}  // namespace
+
+//==============================================================================
+
+BBCodeTagRegistry::BBCodeTagRegistry()
+{
+    auto table = std::make_unique<Table>();
+    m_table.store( table.get(), std::memory_order_release );
+    m_tables.push_back( std::move( table ) );
+}
+//==============================================================================
+
+BBCodeTagRegistry& BBCodeTagRegistry::getInstance()
+{
+    static BBCodeTagRegistry instance;
+    return instance;
+}
+//==============================================================================
+
+const BBCodeTagRegistry::Tag* BBCodeTagRegistry::find( std::string_view name ) const noexcept
+{
+    return m_table.load( std::memory_order_acquire )->find( name, hashName( name ) );
+}
+//==============================================================================
+
+bool BBCodeTagRegistry::add( std::string_view name, ParseFunction parse )
+{
+    jassert( parse != nullptr );
+
+    const juce::ScopedLock lock( m_lock );
+
+    const auto& current = *m_table.load( std::memory_order_relaxed );
+    if( parse == nullptr || !isValidTagName( name ) || isBuiltInTagName( name ) || current.numTags == kMaxTags
+        || current.find( name, hashName( name ) ) != nullptr )
+        return false;
+
+    auto& lowerCaseName = m_names.emplace_back( name );
+    std::transform( lowerCaseName.begin(), lowerCaseName.end(), lowerCaseName.begin(), []( char character ) noexcept {
+        return ( character >= 'A' && character <= 'Z' ) ? static_cast<char>( character - 'A' + 'a' ) : character;
+    } );
+
+    // Lookups in progress keep reading the old table...
+    auto table = std::make_unique<Table>( current );
+    table->insert( { lowerCaseName, hashName( lowerCaseName ), parse } );
+
+    m_table.store( table.get(), std::memory_order_release );
+    m_tables.push_back( std::move( table ) );
+    return true;
+}
+//==============================================================================
+
+const BBCodeTagRegistry::Tag* BBCodeTagRegistry::Table::find( std::string_view name, juce::uint32 hash ) const noexcept
+{
+    // The table is at most half full, so there always is an empty slot to end on...
+    for( auto index = hash % kNumSlots;; index = ( index + 1 ) % kNumSlots )
+    {
+        const auto& slot = slots[index];
+        if( slot.name.empty() )
+            return nullptr;
+        if( slot.hash == hash && compareIgnoreCase( slot.name, name ) == 0 )
+            return &slot;
+    }
+}
+//==============================================================================
+
+void BBCodeTagRegistry::Table::insert( const Tag& tag ) noexcept
+{
+    jassert( numTags < kMaxTags );
+
+    auto index = tag.hash % kNumSlots;
+    while( !slots[index].name.empty() )
+        index = ( index + 1 ) % kNumSlots;
+
+    slots[index] = tag;
+    ++numTags;
+}
+//==============================================================================
+
+}  // namespace sd
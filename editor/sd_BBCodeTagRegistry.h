@@ -0,0 +1,117 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeTagRegistry.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Process wide table of the tags the application adds.
+ *
+ * The built-in tags are matched by TextFormatState itself; a tag only ends up
+ * here when it is none of those. Tags are found by a precomputed hash of their
+ * name, in an open addressed table, and change the format through a plain
+ * function pointer.
+ *
+ * Lookups do not lock. Adding a tag publishes a new table; register application
+ * tags at startup, before any text is parsed, so cached documents stay valid.
+ *
+ * @see TextFormatState::withTag, BBCodeParser
+ */
+class BBCodeTagRegistry
+{
+public:
+    /**
+     * Changes a state for a tag.
+     *
+     * @param state  The state to change.
+     * @param value  Everything after '=' in the tag, empty if it has none.
+     * @param enable True for the opening tag, false for the closing one.
+     * @return       Whether the state changed. If not, the tag is shown as text.
+     */
+    using ParseFunction = TextFormatState::StateChanged ( * )( TextFormatState& state, std::string_view value, bool enable );
+
+    struct Tag
+    {
+        std::string_view name;               ///< Lower case.
+        juce::uint32     hash { 0 };         ///< See hashName.
+        ParseFunction    parse { nullptr };  ///< Changes the format.
+    };
+
+    /** Maximum number of application tags. */
+    static constexpr size_t kMaxTags { 32 };
+
+    /** @brief Get the process wide instance. */
+    static BBCodeTagRegistry& getInstance();
+
+    /**
+     * @brief Find a tag by name.
+     *
+     * @param name The tag name, without '/' and value. Case is ignored.
+     * @return     The tag, or nullptr if there is none by that name. Stays valid.
+     */
+    [[nodiscard]] const Tag* find( std::string_view name ) const noexcept;
+
+    /**
+     * @brief Add an application tag.
+     *
+     * The tag changes the format like [b] does. The setters of TextFormatState can
+     * be combined, e.g. [h1] could set the height and bold style.
+     *
+     * @param name  The tag name. Case is ignored.
+     * @param parse Changes the format for the tag.
+     * @return      False if the name is taken, can not be a tag name, or the table is full.
+     *              Names of built-in tags are taken, as are names starting with code, quote or align.
+     */
+    bool add( std::string_view name, ParseFunction parse );
+
+    /** @brief Get the number of application tags. */
+    [[nodiscard]] size_t getNumTags() const noexcept { return m_table.load( std::memory_order_acquire )->numTags; }
+
+    /** @brief Get the hash of a tag name, ignoring case (32 bit FNV-1a). */
+    static constexpr juce::uint32 hashName( std::string_view name ) noexcept
+    {
+        juce::uint32 hash { 2166136261U };
+        for( const auto character : name )
+        {
+            const auto lowerCase = ( character >= 'A' && character <= 'Z' ) ? static_cast<char>( character - 'A' + 'a' ) : character;
+            hash                 = ( hash ^ static_cast<juce::uint8>( lowerCase ) ) * 16777619U;
+        }
+        return hash;
+    }
+
+private:
+    static constexpr size_t kNumSlots { 2 * kMaxTags };  // Keeps probe sequences short.
+
+    struct Table
+    {
+        std::array<Tag, kNumSlots> slots {};  // Slots without name are empty.
+        size_t                     numTags { 0 };
+
+        const Tag* find( std::string_view name, juce::uint32 hash ) const noexcept;
+        void       insert( const Tag& tag ) noexcept;
+    };
+
+    std::atomic<const Table*>           m_table { nullptr };
+    std::vector<std::unique_ptr<Table>> m_tables;  // Every table published, lookups may still be reading an older one.
+    std::list<std::string>              m_names;   // Names of the application tags, lower case.
+    juce::CriticalSection               m_lock;    // Serialises add.
+
+    BBCodeTagRegistry();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBCodeTagRegistry )
+};
+
+}  // namespace sd
@@ -0,0 +1,288 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeTokenizer.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#if BBCODE_EDITOR_USE_SIMD
+ #if defined( __SSE2__ ) || defined( _M_X64 )
+  #define BBCODE_TOKENIZER_SSE2 1
+  #include <immintrin.h>
+ #elif defined( __ARM_NEON ) || defined( _M_ARM64 )
+  #define BBCODE_TOKENIZER_NEON 1
+  #include <arm_neon.h>
+ #endif
+ #if defined( _MSC_VER )
+  #include <intrin.h>
+ #endif
+#endif
+
+#if defined( BBCODE_TOKENIZER_SSE2 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+ #define BBCODE_TOKENIZER_AVX2_TARGET __attribute__( ( target( "avx2" ) ) )
+#else
+ #define BBCODE_TOKENIZER_AVX2_TARGET
+#endif
+
+
+namespace sd
+{
+
+namespace
+{
+
+//==============================================================================
+
+/** Finds the first of two characters. Returns the size if neither occurs. */
+using FindFirstOfFunction = size_t ( * )( const char* data, size_t size, char first, char second ) noexcept;
+
+size_t findFirstOfScalar( const char* data, size_t size, char first, char second ) noexcept
+{
+    for( size_t index = 0; index < size; ++index )
+        if( data[index] == first || data[index] == second )
+            return index;
+    return size;
+}
+//==============================================================================
+
+#if defined( BBCODE_TOKENIZER_SSE2 ) || defined( BBCODE_TOKENIZER_NEON )
+
+int countTrailingZeros( juce::uint64 bits ) noexcept
+{
+    jassert( bits != 0 );
+ #if defined( _MSC_VER ) && !defined( __clang__ )
+    unsigned long index { 0 };
+    _BitScanForward64( &index, bits );
+    return static_cast<int>( index );
+ #else
+    return __builtin_ctzll( bits );
+ #endif
+}
+//==============================================================================
+
+#endif
+
+#if defined( BBCODE_TOKENIZER_SSE2 )
+
+size_t findFirstOfSSE2( const char* data, size_t size, char first, char second ) noexcept
+{
+    const auto firstVector  = _mm_set1_epi8( first );
+    const auto secondVector = _mm_set1_epi8( second );
+
+    size_t index { 0 };
+    for( ; index + 16 <= size; index += 16 )
+    {
+        const auto chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + index ) );
+        const auto found = _mm_or_si128( _mm_cmpeq_epi8( chunk, firstVector ), _mm_cmpeq_epi8( chunk, secondVector ) );
+        if( const auto mask = static_cast<juce::uint32>( _mm_movemask_epi8( found ) ); mask != 0 )
+            return index + static_cast<size_t>( countTrailingZeros( mask ) );
+    }
+    return index + findFirstOfScalar( data + index, size - index, first, second );
+}
+//==============================================================================
+
+BBCODE_TOKENIZER_AVX2_TARGET size_t findFirstOfAVX2( const char* data, size_t size, char first, char second ) noexcept
+{
+    const auto firstVector  = _mm256_set1_epi8( first );
+    const auto secondVector = _mm256_set1_epi8( second );
+
+    size_t index { 0 };
+    for( ; index + 32 <= size; index += 32 )
+    {
+        const auto chunk = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + index ) );
+        const auto found = _mm256_or_si256( _mm256_cmpeq_epi8( chunk, firstVector ), _mm256_cmpeq_epi8( chunk, secondVector ) );
+        if( const auto mask = static_cast<juce::uint32>( _mm256_movemask_epi8( found ) ); mask != 0 )
+            return index + static_cast<size_t>( countTrailingZeros( mask ) );
+    }
+    return index + findFirstOfSSE2( data + index, size - index, first, second );
+}
+//==============================================================================
+
+#elif defined( BBCODE_TOKENIZER_NEON )
+
+size_t findFirstOfNEON( const char* data, size_t size, char first, char second ) noexcept
+{
+    const auto firstVector  = vdupq_n_u8( static_cast<juce::uint8>( first ) );
+    const auto secondVector = vdupq_n_u8( static_cast<juce::uint8>( second ) );
+
+    size_t index { 0 };
+    for( ; index + 16 <= size; index += 16 )
+    {
+        const auto chunk = vld1q_u8( reinterpret_cast<const juce::uint8*>( data + index ) );
+        const auto found = vorrq_u8( vceqq_u8( chunk, firstVector ), vceqq_u8( chunk, secondVector ) );
+
+        // NEON has no movemask: narrowing leaves four bits per byte...
+        const auto mask = vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( found ), 4 ) ), 0 );
+        if( mask != 0 )
+            return index + static_cast<size_t>( countTrailingZeros( mask ) / 4 );
+    }
+    return index + findFirstOfScalar( data + index, size - index, first, second );
+}
+//==============================================================================
+
+#endif
+
+FindFirstOfFunction selectFindFirstOf() noexcept
+{
+#if defined( BBCODE_TOKENIZER_SSE2 )
+    return juce::SystemStats::hasAVX2() ? findFirstOfAVX2 : findFirstOfSSE2;
+#elif defined( BBCODE_TOKENIZER_NEON )
+    return findFirstOfNEON;
+#else
+    return findFirstOfScalar;
+#endif
+}
+//==============================================================================
+
+size_t findFirstOf( std::string_view text, size_t from, char first, char second ) noexcept
+{
+    static const auto function = selectFindFirstOf();
+
+    if( from >= text.size() )
+        return text.size();
+    return from + function( text.data() + from, text.size() - from, first, second );
+}
+//==============================================================================
+
+}  // namespace
+
+//==============================================================================
+
+std::optional<BBCodeTokenizer::Token> BBCodeTokenizer::next() noexcept
+{
+    const auto tokenStart = *BBCode::kTokenStart;
+    const auto size       = m_text.size();
+
+    // Plain text up to the first '['...
+    if( !m_started )
+    {
+        m_started  = true;
+        m_position = find( tokenStart, 0 );
+        markScanned( m_position );
+        if( m_position > 0 )
+        {
+            Token token;
+            token.text   = m_text.substr( 0, m_position );
+            token.source = token.text;
+            return token;
+        }
+    }
+
+    while( m_position < size )
+    {
+        const auto start = m_position + 1;
+        auto       end   = findDelimiter( start );
+
+        // A ']' first closes this tag, remember it and go on to the next '['...
+        if( end < size && m_text[end] == *BBCode::kTokenEnd )
+        {
+            m_nextTokenEnd = { start, end };
+            end            = find( tokenStart, end + 1 );
+        }
+        m_position = end;
+        markScanned( end );
+
+        if( start == end )
+        {
+            // A trailing '[' is dropped...
+            if( end == size )
+                break;
+
+            // Superfluous '['...
+            Token token;
+            token.text   = m_text.substr( start - 1, 1 );
+            token.source = token.text;
+            return token;
+        }
+
+        // The tag runs up to the first ']', even if that lies beyond the next '['...
+        const auto tagEnd = find( m_nextTokenEnd, *BBCode::kTokenEnd, start );
+        markScanned( tagEnd );
+
+        Token token;
+        token.tag       = m_text.substr( start, tagEnd - start );
+        token.source    = m_text.substr( start - 1, end - start + 1 );
+        token.malformed = tagEnd > end;
+
+        const auto valueDelimiter = std::min( find( m_nextValueDelimiter, *BBCode::kValueDelimiter, start ), tagEnd );
+        if( valueDelimiter < tagEnd )
+            token.value = m_text.substr( valueDelimiter + 1, tagEnd - valueDelimiter - 1 );
+
+        if( startsWith( token.tag, BBCode::kBulletToken ) )
+        {
+            token.type = Token::Type::bullet;
+            token.name = token.tag.substr( 0, 1 );
+            if( tagEnd < size )
+            {
+                const auto textEnd = tagEnd < end ? end : find( m_nextBulletTextEnd, tokenStart, tagEnd + 1 );
+                markScanned( textEnd );
+                token.text         = m_text.substr( tagEnd + 1, textEnd - tagEnd - 1 );
+            }
+            return token;
+        }
+
+        token.type = startsWith( token.tag, BBCode::kCloseTokenPrefix ) ? Token::Type::closeTag : Token::Type::openTag;
+        token.name = m_text.substr( start, valueDelimiter - start );
+        token.name.remove_prefix( std::min( token.name.find_first_not_of( *BBCode::kCloseTokenPrefix ), token.name.size() ) );
+        if( tagEnd < end )
+            token.text = m_text.substr( tagEnd + 1, end - tagEnd - 1 );
+        return token;
+    }
+
+    return std::nullopt;
+}
+//==============================================================================
+
+bool BBCodeTokenizer::startsWith( std::string_view text, std::string_view prefix ) noexcept
+{
+    return text.substr( 0, prefix.size() ) == prefix;
+}
+//==============================================================================
+
+juce::String BBCodeTokenizer::toString( std::string_view text )
+{
+    if( text.empty() )
+        return {};
+
+    return juce::String::fromUTF8( text.data(), static_cast<int>( text.size() ) );
+}
+//==============================================================================
+
+size_t BBCodeTokenizer::find( char character, size_t from ) const noexcept
+{
+    return std::min( m_text.find( character, from ), m_text.size() );
+}
+//==============================================================================
+
+size_t BBCodeTokenizer::findDelimiter( size_t from ) const noexcept
+{
+    return findFirstOf( m_text, from, *BBCode::kTokenStart, *BBCode::kTokenEnd );
+}
+//==============================================================================
+
+void BBCodeTokenizer::markScanned( size_t found ) noexcept
+{
+    // Not finding a character depends on the end of the text...
+    m_scanEnd = std::max( m_scanEnd, found + 1 );
+}
+//==============================================================================
+
+size_t BBCodeTokenizer::find( Search& search, char character, size_t from ) const noexcept
+{
+    // The previous result still holds if nothing was skipped since...
+    if( search.from > from || search.found < from )
+    {
+        search.from  = from;
+        search.found = find( character, from );
+    }
+    return search.found;
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,98 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeTokenizer.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Single pass BBCode tokenizer.
+ *
+ * Walks a UTF-8 buffer once, front to back, and splits it into tokens.
+ * Tokens are views into the buffer, so nothing is copied. The buffer
+ * must outlive the tokenizer and the tokens it returns.
+ *
+ * Every '[' starts a new token, which runs up to the next '['. That is
+ * the granularity BBCodeEditor formats its text in.
+ */
+class BBCodeTokenizer
+{
+public:
+    struct Token
+    {
+        enum class Type
+        {
+            text,      ///< Plain text: the text before the first tag, or an escaped '['.
+            openTag,   ///< [tag] or [tag=value], followed by its text.
+            closeTag,  ///< [/tag], followed by its text.
+            bullet     ///< [*], followed by its text.
+        };
+
+        Type             type { Type::text };
+        std::string_view tag;                 ///< Everything between '[' and ']'.
+        std::string_view name;                ///< Tag name, without close prefix and value.
+        std::string_view value;               ///< Everything after the value delimiter.
+        std::string_view text;                ///< Text following the tag.
+        std::string_view source;              ///< The complete token, from '[' up to the next '['.
+        bool             malformed { false };  ///< True if the next '[' comes before the closing ']'.
+    };
+
+    explicit BBCodeTokenizer( std::string_view bbText ) noexcept : m_text( bbText ) {}
+
+    /**
+     * @brief Get the next token.
+     *
+     * @return The next token or std::nullopt when the end of the text has been reached.
+     */
+    std::optional<Token> next() noexcept;
+
+    /**
+     * @brief Get how far the tokenizer has looked into the text.
+     *
+     * The tokens returned so far only depend on the bytes before this offset.
+     * It is one past the end of the text when a token depended on where the text ends.
+     */
+    [[nodiscard]] size_t getScanEnd() const noexcept { return m_scanEnd; }
+
+    /** @brief Check whether a token part starts with the given prefix (case sensitive). */
+    static bool startsWith( std::string_view text, std::string_view prefix ) noexcept;
+
+    /** @brief Make a juce::String of a token part. */
+    static juce::String toString( std::string_view text );
+
+private:
+    /** Remembers the last search for a character, so repeated searches never scan the same bytes twice. */
+    struct Search
+    {
+        size_t from { std::string_view::npos };
+        size_t found { std::string_view::npos };
+    };
+
+    std::string_view m_text;
+    size_t           m_position { 0 };
+    bool             m_started { false };
+    size_t           m_scanEnd { 0 };
+    Search           m_nextTokenEnd;
+    Search           m_nextValueDelimiter;
+    Search           m_nextBulletTextEnd;
+
+    [[nodiscard]] size_t find( char character, size_t from ) const noexcept;
+    [[nodiscard]] size_t findDelimiter( size_t from ) const noexcept;
+    [[nodiscard]] size_t find( Search& search, char character, size_t from ) const noexcept;
+
+    void markScanned( size_t found ) noexcept;
+};
+
+}  // namespace sd
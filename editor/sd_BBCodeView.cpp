@@ -0,0 +1,418 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeView.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+class BBCodeView::LayoutJob : public juce::ThreadPoolJob
+{
+public:
+    LayoutJob( BBCodeView& view, std::vector<std::pair<size_t, juce::AttributedString>> strings )
+      : juce::ThreadPoolJob( "BBCodeView layout" )
+      , m_view( &view )
+      , m_generation( view.m_layoutGeneration )
+      , m_width( view.m_layoutWidth )
+      , m_strings( std::move( strings ) )
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto layouts = std::make_shared<std::vector<std::pair<size_t, juce::TextLayout>>>();
+        for( const auto& [index, string] : m_strings )
+        {
+            if( shouldExit() )
+                return jobHasFinished;
+
+            layouts->emplace_back( index, juce::TextLayout() );
+            layouts->back().second.createLayout( string, m_width );
+        }
+
+        juce::MessageManager::callAsync( [view = m_view, generation = m_generation, width = m_width, layouts]() {
+            // Deleted, or resized again...
+            if( view == nullptr || view->m_layoutGeneration != generation )
+                return;
+
+            for( auto& [index, layout] : *layouts )
+            {
+                view->measure( index, layout );
+                view->m_layouts[index] = { std::move( layout ), width };
+            }
+            view->updateScrollBar();
+            view->repaint();
+        } );
+        return jobHasFinished;
+    }
+
+private:
+    juce::Component::SafePointer<BBCodeView>                m_view;
+    int                                                     m_generation;
+    float                                                   m_width;
+    std::vector<std::pair<size_t, juce::AttributedString>> m_strings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( LayoutJob )
+};
+//==============================================================================
+
+BBCodeView::BBCodeView()
+{
+    setOpaque( true );
+
+    m_scrollBar.setAutoHide( false );
+    m_scrollBar.setSingleStepSize( kScrollStep );
+    m_scrollBar.addListener( this );
+    addAndMakeVisible( m_scrollBar );
+}
+//==============================================================================
+
+BBCodeView::~BBCodeView()
+{
+    cancelBackgroundLayout();
+    m_scrollBar.removeListener( this );
+}
+//==============================================================================
+
+void BBCodeView::setBBText( const juce::String& bbText )
+{
+    BBCodeParser parser { findColour( juce::TextEditor::textColourId ) };
+    setBBDocument( parser.parse( bbText ) );
+}
+//==============================================================================
+
+void BBCodeView::setBBDocument( BBDocument document )
+{
+    cancelBackgroundLayout();
+
+    m_document = std::move( document );
+    m_layouts.clear();
+
+    splitParagraphs();
+    estimateHeights();
+    updateScrollBar();
+    m_scrollBar.setCurrentRangeStart( 0.0 );
+
+    layOutVisibleParagraphs();
+    repaint();
+}
+//==============================================================================
+
+void BBCodeView::setBackgroundLayout( bool shouldLayOutInBackground )
+{
+    if( !shouldLayOutInBackground )
+    {
+        cancelBackgroundLayout();
+        m_layoutPool.reset();
+        layOutVisibleParagraphs();
+        repaint();
+    }
+    else if( m_layoutPool == nullptr )
+    {
+        m_layoutPool = std::make_unique<juce::ThreadPool>( 1 );
+    }
+}
+//==============================================================================
+
+void BBCodeView::setScrollPosition( double position )
+{
+    m_scrollBar.setCurrentRangeStart( position );
+}
+//==============================================================================
+
+void BBCodeView::paint( juce::Graphics& g )
+{
+    g.fillAll( findColour( juce::TextEditor::backgroundColourId ) );
+
+    const auto top = getScrollPosition();
+    for( const auto& [index, layout] : m_layouts )
+    {
+        const auto y      = static_cast<float>( kPadding + m_heights.getStart( index ) - top );
+        const auto height = layout.layout.getHeight();
+        if( y + height >= 0.0F && y < static_cast<float>( getHeight() ) )
+            layout.layout.draw( g, { kPadding, y, layout.width, height } );
+    }
+}
+//==============================================================================
+
+void BBCodeView::resized()
+{
+    m_scrollBar.setBounds( getLocalBounds().removeFromRight( getLookAndFeel().getDefaultScrollbarWidth() ) );
+
+    // Line wrapping changes with the width, keep the paragraph at the top in place...
+    if( getLayoutWidth() != m_layoutWidth && !m_paragraphs.empty() )
+    {
+        const auto top      = getScrollPosition();
+        const auto anchor   = m_heights.find( top );
+        const auto fraction = ( top - m_heights.getStart( anchor ) ) / std::max( m_heights.get( anchor ), 1.0 );
+
+        cancelBackgroundLayout();
+        estimateHeights();
+
+        // Paragraphs on one line that still fit keep their layout...
+        for( auto layout = m_layouts.begin(); layout != m_layouts.end(); )
+        {
+            if( m_paragraphs[layout->first].measured )
+                layout->second.width = m_layoutWidth;
+
+            // ...without background layout the others are laid out again right away.
+            if( layout->second.width != m_layoutWidth && m_layoutPool == nullptr )
+                layout = m_layouts.erase( layout );
+            else
+                ++layout;
+        }
+
+        updateScrollBar();
+        m_scrollBar.setCurrentRangeStart( m_heights.getStart( anchor ) + fraction * m_heights.get( anchor ) );
+    }
+
+    layOutVisibleParagraphs();
+}
+//==============================================================================
+
+void BBCodeView::mouseWheelMove( const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel )
+{
+    m_scrollBar.mouseWheelMove( event, wheel );
+}
+//==============================================================================
+
+void BBCodeView::scrollBarMoved( juce::ScrollBar* /*scrollBar*/, double /*newRangeStart*/ )
+{
+    layOutVisibleParagraphs();
+    repaint();
+}
+//==============================================================================
+
+float BBCodeView::getTextWidth() const noexcept
+{
+    return std::max( 1.0F, static_cast<float>( getWidth() - m_scrollBar.getWidth() ) - 2.0F * kPadding );
+}
+//==============================================================================
+
+float BBCodeView::getLayoutWidth() const noexcept
+{
+    return std::max( kWidthQuantum, std::floor( getTextWidth() / kWidthQuantum ) * kWidthQuantum );
+}
+//==============================================================================
+
+void BBCodeView::splitParagraphs()
+{
+    m_paragraphs.clear();
+
+    const auto text = m_document.getText();
+    Paragraph  paragraph;
+
+    const auto addParagraph = [this, &text, &paragraph]( size_t lineBreak ) {
+        paragraph.textEnd = static_cast<juce::uint32>( lineBreak > paragraph.textStart && text[lineBreak - 1] == '\r' ? lineBreak - 1 : lineBreak );
+        m_paragraphs.push_back( paragraph );
+    };
+
+    for( size_t runIndex = 0; runIndex < m_document.getNumRuns(); ++runIndex )
+    {
+        // Only search the text of the run, a run without line breaks must not scan the rest of the document...
+        const auto& run     = m_document.getRun( runIndex );
+        const auto  runText = m_document.getText( run );
+        for( auto lineBreak = runText.find( '\n' ); lineBreak != std::string_view::npos; lineBreak = runText.find( '\n', lineBreak + 1 ) )
+        {
+            addParagraph( run.offset + lineBreak );
+            paragraph.textStart = static_cast<juce::uint32>( run.offset + lineBreak + 1 );
+            paragraph.firstRun  = static_cast<juce::uint32>( lineBreak + 1 < runText.size() ? runIndex : runIndex + 1 );
+        }
+    }
+    addParagraph( text.size() );
+}
+//==============================================================================
+
+void BBCodeView::estimateHeights()
+{
+    m_layoutWidth = getLayoutWidth();
+
+    std::vector<double> heights;
+    heights.reserve( m_paragraphs.size() );
+    for( size_t index = 0; index < m_paragraphs.size(); ++index )
+    {
+        // A measured paragraph on one line keeps its height while it fits...
+        auto& paragraph    = m_paragraphs[index];
+        paragraph.measured = paragraph.measured && paragraph.fitWidth >= 0.0F && paragraph.fitWidth <= m_layoutWidth;
+        heights.push_back( paragraph.measured ? m_heights.get( index ) : estimateHeight( paragraph, m_layoutWidth ) );
+    }
+    m_heights.assign( heights );
+}
+//==============================================================================
+
+double BBCodeView::estimateHeight( const Paragraph& paragraph, float width ) const noexcept
+{
+    const auto fontHeight   = paragraph.firstRun < m_document.getNumRuns() ? m_document.getState( m_document.getRun( paragraph.firstRun ) ).getFontHeight()
+                                                                           : TextFormatState::kDefaultFontHeight;
+    const auto charsPerLine = std::max( 1.0F, width / ( fontHeight * kAverageCharWidth ) );
+    const auto numLines     = std::max( 1.0F, std::ceil( static_cast<float>( paragraph.textEnd - paragraph.textStart ) / charsPerLine ) );
+    return static_cast<double>( numLines * fontHeight );
+}
+//==============================================================================
+
+void BBCodeView::measure( size_t index, const juce::TextLayout& layout )
+{
+    auto&      paragraph   = m_paragraphs[index];
+    const auto leftAligned = paragraph.firstRun >= m_document.getNumRuns() || m_document.getRun( paragraph.firstRun ).alignment == BBDocument::Alignment::left;
+
+    m_heights.set( index, layout.getHeight() );
+    paragraph.fitWidth = leftAligned && layout.getNumLines() == 1 ? layout.getWidth() : -1.0F;
+    paragraph.measured = true;
+}
+//==============================================================================
+
+void BBCodeView::layOutVisibleParagraphs()
+{
+    const auto top    = getScrollPosition();
+    const auto bottom = top + getHeight();
+    const auto first  = m_heights.find( top );
+    auto       last   = first;
+
+    std::vector<size_t> outdated;
+
+    // Laying out replaces estimated heights, which moves the paragraphs below...
+    for( ; last < m_paragraphs.size() && m_heights.getStart( last ) < bottom; ++last )
+    {
+        auto layout = m_layouts.find( last );
+        if( layout != m_layouts.end() && layout->second.width != m_layoutWidth && m_layoutPool != nullptr )
+        {
+            // Drawn as it was until the background layout is done...
+            outdated.push_back( last );
+            continue;
+        }
+
+        if( layout == m_layouts.end() || layout->second.width != m_layoutWidth )
+        {
+            layout                = m_layouts.insert_or_assign( last, Layout { {}, m_layoutWidth } ).first;
+            layout->second.layout.createLayout( createParagraphString( m_paragraphs[last] ), m_layoutWidth );
+            m_paragraphs[last].measured = false;
+        }
+
+        if( !m_paragraphs[last].measured )
+            measure( last, layout->second.layout );
+    }
+
+    // Only paragraphs in or near the view keep their layout...
+    m_layouts.erase( m_layouts.begin(), m_layouts.lower_bound( first > kKeptLayouts ? first - kKeptLayouts : 0 ) );
+    m_layouts.erase( m_layouts.upper_bound( last + kKeptLayouts ), m_layouts.end() );
+
+    if( !outdated.empty() )
+        layOutInBackground( outdated );
+
+    updateScrollBar();
+}
+//==============================================================================
+
+void BBCodeView::layOutInBackground( const std::vector<size_t>& indices )
+{
+    cancelBackgroundLayout();
+
+    std::vector<std::pair<size_t, juce::AttributedString>> strings;
+    strings.reserve( indices.size() );
+    for( const auto index : indices )
+        strings.emplace_back( index, createParagraphString( m_paragraphs[index] ) );
+
+    m_layoutPool->addJob( new LayoutJob( *this, std::move( strings ) ), true );
+}
+//==============================================================================
+
+void BBCodeView::cancelBackgroundLayout()
+{
+    ++m_layoutGeneration;
+    if( m_layoutPool != nullptr )
+        m_layoutPool->removeAllJobs( true, 0 );
+}
+//==============================================================================
+
+void BBCodeView::updateScrollBar()
+{
+    m_scrollBar.setRangeLimits( 0.0, std::max( m_heights.getTotal() + 2.0 * kPadding, static_cast<double>( getHeight() ) ) );
+    m_scrollBar.setCurrentRange( getScrollPosition(), getHeight() );
+}
+//==============================================================================
+
+juce::AttributedString BBCodeView::createParagraphString( const Paragraph& paragraph ) const
+{
+    juce::AttributedString string;
+    string.setWordWrap( juce::AttributedString::byWord );
+
+    appendToAttributedString( string, m_document, paragraph.textStart, paragraph.textEnd );
+
+    // An empty line is still one line high...
+    if( string.getText().isEmpty() )
+    {
+        const auto state = paragraph.firstRun < m_document.getNumRuns() ? m_document.getState( m_document.getRun( paragraph.firstRun ) ) : TextFormatState {};
+        string.append( " ", state.getFont(), state.getColour() );
+    }
+
+    if( paragraph.firstRun < m_document.getNumRuns() )
+        string.setJustification( BBDocument::toJustification( m_document.getRun( paragraph.firstRun ).alignment ) );
+
+    return string;
+}
+//==============================================================================
+
+void BBCodeView::HeightIndex::assign( const std::vector<double>& heights )
+{
+    m_heights = heights;
+    m_tree.assign( heights.size() + 1, 0.0 );
+
+    for( size_t index = 1; index < m_tree.size(); ++index )
+    {
+        m_tree[index] += heights[index - 1];
+        if( const auto parent = index + ( index & ( ~index + 1 ) ); parent < m_tree.size() )
+            m_tree[parent] += m_tree[index];
+    }
+}
+//==============================================================================
+
+void BBCodeView::HeightIndex::set( size_t index, double height )
+{
+    const auto delta = height - m_heights[index];
+    m_heights[index] = height;
+
+    for( auto node = index + 1; node < m_tree.size(); node += node & ( ~node + 1 ) )
+        m_tree[node] += delta;
+}
+//==============================================================================
+
+double BBCodeView::HeightIndex::getStart( size_t index ) const noexcept
+{
+    double start { 0.0 };
+    for( auto node = index; node > 0; node -= node & ( ~node + 1 ) )
+        start += m_tree[node];
+    return start;
+}
+//==============================================================================
+
+size_t BBCodeView::HeightIndex::find( double position ) const noexcept
+{
+    if( m_heights.empty() )
+        return 0;
+
+    // Count the paragraphs that end at or above the position...
+    size_t index { 0 };
+    auto   step = juce::nextPowerOfTwo( static_cast<int>( m_heights.size() ) );
+    for( ; step > 0; step >>= 1 )
+    {
+        const auto next = index + static_cast<size_t>( step );
+        if( next < m_tree.size() && m_tree[next] <= position )
+        {
+            index = next;
+            position -= m_tree[next];
+        }
+    }
+    return std::min( index, m_heights.size() - 1 );
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,149 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeView.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Read-only viewer for large BBCode documents.
+ *
+ * Unlike BBCodeEditor, which inserts every character into a juce::TextEditor,
+ * the view only lays out the paragraphs that are visible. Each one gets its own
+ * juce::TextLayout, created when it scrolls into view and dropped when it
+ * scrolls out. Paragraphs that were never shown have an estimated height,
+ * which is replaced by the real one once laid out.
+ *
+ * Layouts are made for the width rounded down to kWidthQuantum pixels, so small
+ * resizes do not lay out anything. Left aligned paragraphs that fit on one line,
+ * like most code block lines, keep their layout when the width changes as long
+ * as they still fit. The remaining ones can optionally be laid out on a
+ * background thread, see setBackgroundLayout.
+ *
+ * Uses the juce::TextEditor colour ids for text and background. Unlike the
+ * editor, alignment is applied per paragraph.
+ *
+ * @see BBCodeEditor
+ */
+class BBCodeView
+  : public juce::Component
+  , private juce::ScrollBar::Listener
+{
+public:
+    BBCodeView();
+    ~BBCodeView() override;
+
+    /** @brief Show BBCode formatted text. */
+    void setBBText( const juce::String& bbText );
+
+    /** @brief Show a parsed document. */
+    void setBBDocument( BBDocument document );
+
+    /** @brief Get the number of pixels scrolled from the top. */
+    [[nodiscard]] double getScrollPosition() const noexcept { return m_scrollBar.getCurrentRangeStart(); }
+
+    /** @brief Scroll to a number of pixels from the top. */
+    void setScrollPosition( double position );
+
+    /**
+     * @brief Lay out paragraphs on a background thread after a width change.
+     *
+     * Until their new layout is ready, visible paragraphs are drawn with their
+     * layout for the previous width. That keeps resizing by dragging smooth.
+     * Paragraphs that scroll into view are always laid out right away.
+     *
+     * @param shouldLayOutInBackground True to lay out in the background, false to lay out right away (the default).
+     */
+    void setBackgroundLayout( bool shouldLayOutInBackground );
+
+    /** @brief Get the number of paragraphs that currently have a layout. */
+    [[nodiscard]] size_t getNumLaidOutParagraphs() const noexcept { return m_layouts.size(); }
+
+    /** @internal */
+    void paint( juce::Graphics& g ) override;
+    /** @internal */
+    void resized() override;
+    /** @internal */
+    void mouseWheelMove( const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel ) override;
+
+private:
+    static constexpr float  kPadding { 4.0F };
+    static constexpr float  kAverageCharWidth { 0.5F };  // Relative to the font height, for estimating.
+    static constexpr float  kWidthQuantum { 8.0F };  // Layout widths are rounded down to a multiple of this.
+    static constexpr double kScrollStep { 16.0 };    // Pixels per scroll bar step, the mouse wheel scrolls a multiple.
+    static constexpr size_t kKeptLayouts { 8 };      // Paragraphs above and below the visible ones that keep their layout.
+
+    class LayoutJob;
+
+    /** A line of text, up to a '\n'. */
+    struct Paragraph
+    {
+        juce::uint32 textStart { 0 };     ///< Offset in bytes of the first character in the document text.
+        juce::uint32 textEnd { 0 };       ///< Offset in bytes past the last character, without line break.
+        juce::uint32 firstRun { 0 };      ///< The run holding the first character.
+        float        fitWidth { -1.0F };  ///< Width of the text if measured, left aligned and on one line, else negative.
+        bool         measured { false };
+    };
+
+    struct Layout
+    {
+        juce::TextLayout layout;
+        float            width { 0.0F };  ///< The layout width it is valid for.
+    };
+
+    /** Paragraph heights as a Fenwick tree, so positions and paragraphs are found in O(log n). */
+    class HeightIndex
+    {
+    public:
+        void   assign( const std::vector<double>& heights );
+        void   set( size_t index, double height );
+        double get( size_t index ) const noexcept { return m_heights[index]; }
+        double getStart( size_t index ) const noexcept;
+        double getTotal() const noexcept { return getStart( m_heights.size() ); }
+        size_t find( double position ) const noexcept;
+
+    private:
+        std::vector<double> m_heights;
+        std::vector<double> m_tree;
+    };
+
+    BBDocument                         m_document;
+    std::vector<Paragraph>             m_paragraphs;
+    HeightIndex                        m_heights;
+    std::map<size_t, Layout>           m_layouts;  // Keyed by paragraph index.
+    float                              m_layoutWidth { 0.0F };
+    juce::ScrollBar                    m_scrollBar { true };
+    std::unique_ptr<juce::ThreadPool>  m_layoutPool;
+    int                                m_layoutGeneration { 0 };
+
+    float  getTextWidth() const noexcept;
+    float  getLayoutWidth() const noexcept;
+    void   splitParagraphs();
+    void   estimateHeights();
+    double estimateHeight( const Paragraph& paragraph, float width ) const noexcept;
+    void   measure( size_t index, const juce::TextLayout& layout );
+    void   layOutVisibleParagraphs();
+    void   layOutInBackground( const std::vector<size_t>& indices );
+    void   cancelBackgroundLayout();
+    void   updateScrollBar();
+
+    juce::AttributedString createParagraphString( const Paragraph& paragraph ) const;
+
+    void scrollBarMoved( juce::ScrollBar* scrollBar, double newRangeStart ) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBCodeView )
+};
+
+}  // namespace sd
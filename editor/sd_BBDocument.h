@@ -0,0 +1,117 @@
+/*
+  =====================================================================================================
+
+    sd_BBDocument.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Parsed BBCode, ready to be displayed.
+ *
+ * Holds the visible text as one flat UTF-8 buffer, cut into runs of
+ * equally formatted text. Bullets, quote marks and code block padding
+ * are already part of the text. The format states are interned: runs
+ * refer to them by index.
+ *
+ * Text that does not change the format continues the previous run, so
+ * neighbouring runs only share a state when their flags or alignment
+ * differ, or when a parser checkpoint lies between them.
+ *
+ * Documents are created by BBCodeParser and never change afterwards.
+ *
+ * @see BBCodeParser
+ */
+class BBDocument
+{
+public:
+    /** Horizontal alignment set by [align=...]. */
+    enum class Alignment : juce::uint8
+    {
+        left,
+        right,
+        centre,
+        justify
+    };
+
+    /** Markers telling where the text of a run came from. */
+    enum RunFlags : juce::uint8
+    {
+        plain       = 0,
+        listItem    = 1 << 0,  ///< Text of a [*] item, including the bullet.
+        quote       = 1 << 1,  ///< Text of a [quote], including quote marks.
+        quoteHeader = 1 << 2,  ///< The 'name: ' header of a [quote=name].
+        code        = 1 << 3   ///< Text of a [code] block, including its padding.
+    };
+
+    struct Run
+    {
+        juce::uint32 offset { 0 };                   ///< Offset in bytes into the text buffer.
+        juce::uint32 length { 0 };                   ///< Length in bytes.
+        juce::uint16 state { 0 };                    ///< Index of the format state.
+        juce::uint8  flags { plain };                ///< RunFlags.
+        Alignment    alignment { Alignment::left };  ///< Alignment in effect for this run.
+    };
+
+    [[nodiscard]] std::string_view getText() const noexcept { return m_text; }
+    [[nodiscard]] std::string_view getText( const Run& run ) const noexcept { return getText().substr( run.offset, run.length ); }
+
+    [[nodiscard]] const std::vector<Run>& getRuns() const noexcept { return m_runs; }
+    [[nodiscard]] size_t                  getNumRuns() const noexcept { return m_runs.size(); }
+    [[nodiscard]] const Run&              getRun( size_t index ) const noexcept { return m_runs[index]; }
+    [[nodiscard]] bool                    isEmpty() const noexcept { return m_runs.empty(); }
+
+    [[nodiscard]] const TextFormatState& getState( const Run& run ) const noexcept { return m_states[run.state]; }
+    [[nodiscard]] const TextFormatState& getState( size_t index ) const noexcept { return m_states[index]; }
+    [[nodiscard]] size_t                 getNumStates() const noexcept { return m_states.size(); }
+
+    /** @brief Get the approximate heap memory held by the document, in bytes. */
+    [[nodiscard]] size_t getMemoryUsage() const noexcept
+    {
+        return m_text.capacity() + m_runs.capacity() * sizeof( Run ) + m_states.capacity() * sizeof( TextFormatState );
+    }
+
+    /**
+     * @brief Get the justification at the end of the document.
+     *
+     * juce::TextEditor has one justification for all its text. That is
+     * the one set by the last [align] tag.
+     */
+    [[nodiscard]] juce::Justification getJustification() const noexcept { return toJustification( m_alignment ); }
+
+    /** @brief Get the alignment set by the last [align] tag. */
+    [[nodiscard]] Alignment getAlignment() const noexcept { return m_alignment; }
+
+    static juce::Justification toJustification( Alignment alignment ) noexcept
+    {
+        switch( alignment )
+        {
+            case Alignment::right: return juce::Justification::topRight;
+            case Alignment::centre: return juce::Justification::centredTop;
+            case Alignment::justify: return juce::Justification::horizontallyJustified;
+            case Alignment::left:
+            default: return juce::Justification::topLeft;
+        }
+    }
+
+private:
+    friend class BBCodeParser;
+
+    std::string                  m_text;
+    std::vector<Run>             m_runs;
+    std::vector<TextFormatState> m_states;
+    Alignment                    m_alignment { Alignment::left };
+};
+
+}  // namespace sd
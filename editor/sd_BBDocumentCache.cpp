@@ -0,0 +1,125 @@
+/*
+  =====================================================================================================
+
+    sd_BBDocumentCache.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+std::shared_ptr<const BBDocumentCache::Entry> BBDocumentCache::find( const juce::String& bbText, const juce::Colour& defaultColour )
+{
+    const auto key = makeKey( bbText, defaultColour );
+
+    const juce::ScopedLock lock( m_lock );
+
+    const auto item = m_index.find( key );
+    if( item == m_index.end() || item->second->bbText != bbText )
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    m_items.splice( m_items.begin(), m_items, item->second );
+    return item->second->entry;
+}
+//==============================================================================
+
+void BBDocumentCache::add( const juce::String& bbText, const juce::Colour& defaultColour, std::shared_ptr<const Entry> entry )
+{
+    jassert( entry != nullptr );
+
+    const auto key      = makeKey( bbText, defaultColour );
+    const auto numBytes = getMemoryUsage( bbText, *entry );
+
+    const juce::ScopedLock lock( m_lock );
+
+    if( const auto item = m_index.find( key ); item != m_index.end() )
+    {
+        m_numBytes -= item->second->numBytes;
+        m_items.erase( item->second );
+        m_index.erase( item );
+    }
+
+    if( numBytes > m_maxBytes )
+        return;
+
+    evict( m_maxBytes - numBytes );
+
+    m_items.push_front( { key, bbText, std::move( entry ), numBytes } );
+    m_index[key] = m_items.begin();
+    m_numBytes += numBytes;
+}
+//==============================================================================
+
+void BBDocumentCache::setMaxBytes( size_t maxBytes )
+{
+    const juce::ScopedLock lock( m_lock );
+    m_maxBytes = maxBytes;
+    evict( m_maxBytes );
+}
+//==============================================================================
+
+BBDocumentCache::Statistics BBDocumentCache::getStatistics() const
+{
+    const juce::ScopedLock lock( m_lock );
+    return { m_hits, m_misses, m_evictions, m_items.size(), m_numBytes, m_maxBytes };
+}
+//==============================================================================
+
+void BBDocumentCache::clear()
+{
+    const juce::ScopedLock lock( m_lock );
+    m_items.clear();
+    m_index.clear();
+    m_numBytes  = 0;
+    m_hits      = 0;
+    m_misses    = 0;
+    m_evictions = 0;
+}
+//==============================================================================
+
+BBDocumentCache::Key BBDocumentCache::makeKey( const juce::String& bbText, const juce::Colour& defaultColour ) noexcept
+{
+    return { bbText.hashCode64(), bbText.getNumBytesAsUTF8(), defaultColour.getARGB() };
+}
+//==============================================================================
+
+size_t BBDocumentCache::getMemoryUsage( const juce::String& bbText, const Entry& entry ) noexcept
+{
+    const auto getStateBytes = []( const BBCodeParser::Checkpoint& checkpoint ) {
+        return sizeof( checkpoint ) + checkpoint.stateQueue.capacity() * sizeof( TextFormatState );
+    };
+
+    auto numBytes = sizeof( Item ) + sizeof( Entry ) + bbText.getNumBytesAsUTF8() + entry.document.getMemoryUsage() + getStateBytes( entry.endState );
+    for( const auto& checkpoint : entry.checkpoints )
+        numBytes += getStateBytes( checkpoint );
+
+    return numBytes;
+}
+//==============================================================================
+
+void BBDocumentCache::evict( size_t maxBytes )
+{
+    while( m_numBytes > maxBytes && !m_items.empty() )
+    {
+        m_numBytes -= m_items.back().numBytes;
+        m_index.erase( m_items.back().key );
+        m_items.pop_back();
+        ++m_evictions;
+    }
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,121 @@
+/*
+  =====================================================================================================
+
+    sd_BBDocumentCache.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Size bounded cache of parsed BBCode.
+ *
+ * Maps BBCode text and the default text colour it was parsed with to the
+ * parsed document. When the cache is full, the least recently used documents
+ * are evicted.
+ *
+ * An editor only uses a cache when it is given one, and a cache can be
+ * shared by several editors. All functions are thread safe.
+ *
+ * @see BBCodeEditor::setDocumentCache
+ */
+class BBDocumentCache
+{
+public:
+    static constexpr size_t kDefaultMaxBytes { 16 * 1024 * 1024 };
+
+    /** Everything needed to show parsed text without parsing it again. */
+    struct Entry
+    {
+        BBDocument                            document;
+        std::vector<BBCodeParser::Checkpoint> checkpoints;  ///< As recorded by BBCodeParser::parseNext.
+        BBCodeParser::Checkpoint              endState;     ///< Parser state at the end, to append text to.
+    };
+
+    struct Statistics
+    {
+        juce::uint64 hits { 0 };
+        juce::uint64 misses { 0 };
+        juce::uint64 evictions { 0 };
+        size_t       numEntries { 0 };
+        size_t       numBytes { 0 };  ///< Approximate memory held by the entries.
+        size_t       maxBytes { 0 };
+    };
+
+    explicit BBDocumentCache( size_t maxBytes = kDefaultMaxBytes ) : m_maxBytes( maxBytes ) {}
+
+    /**
+     * @brief Find parsed text.
+     *
+     * @param bbText        The BBCode formatted text.
+     * @param defaultColour The colour of text without [color] tag.
+     * @return              The entry or nullptr if the text is not in the cache.
+     */
+    [[nodiscard]] std::shared_ptr<const Entry> find( const juce::String& bbText, const juce::Colour& defaultColour );
+
+    /**
+     * @brief Add parsed text, evicting other entries if needed.
+     *
+     * Entries larger than the maximum size are not added.
+     */
+    void add( const juce::String& bbText, const juce::Colour& defaultColour, std::shared_ptr<const Entry> entry );
+
+    /** @brief Set the approximate maximum memory the entries may hold. */
+    void setMaxBytes( size_t maxBytes );
+
+    /** @brief Get the hit, miss and eviction counts and the current and maximum size. */
+    [[nodiscard]] Statistics getStatistics() const;
+
+    /** @brief Remove all entries and reset the counts. */
+    void clear();
+
+private:
+    struct Key
+    {
+        juce::int64  hash { 0 };
+        size_t       numBytes { 0 };
+        juce::uint32 colour { 0 };
+
+        bool operator==( const Key& other ) const noexcept { return hash == other.hash && numBytes == other.numBytes && colour == other.colour; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()( const Key& key ) const noexcept { return static_cast<size_t>( key.hash ) ^ key.colour; }
+    };
+
+    struct Item
+    {
+        Key                          key;
+        juce::String                 bbText;  // Compared on lookup, so hash collisions are harmless.
+        std::shared_ptr<const Entry> entry;
+        size_t                       numBytes { 0 };
+    };
+
+    juce::CriticalSection                                       m_lock;
+    std::list<Item>                                             m_items;  // Most recently used first.
+    std::unordered_map<Key, std::list<Item>::iterator, KeyHash> m_index;
+    size_t                                                      m_maxBytes;
+    size_t                                                      m_numBytes { 0 };
+    juce::uint64                                                m_hits { 0 };
+    juce::uint64                                                m_misses { 0 };
+    juce::uint64                                                m_evictions { 0 };
+
+    static Key    makeKey( const juce::String& bbText, const juce::Colour& defaultColour ) noexcept;
+    static size_t getMemoryUsage( const juce::String& bbText, const Entry& entry ) noexcept;
+    void          evict( size_t maxBytes );
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBDocumentCache )
+};
+
+}  // namespace sd
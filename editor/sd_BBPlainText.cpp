@@ -0,0 +1,105 @@
+/*
+  =====================================================================================================
+
+    sd_BBPlainText.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+namespace sd
+{
+
+size_t BBPlainText::getSourceOffset( size_t textOffset ) const noexcept
+{
+    // The last segment starting at or before the offset...
+    const auto segment = std::upper_bound( segments.begin(), segments.end(), textOffset,
+                                           []( size_t offset, const Segment& candidate ) noexcept { return offset < candidate.textStart; } );
+    if( segment == segments.begin() )
+        return 0;
+
+    const auto& found = *std::prev( segment );
+    return found.copied ? found.sourceStart + ( textOffset - found.textStart ) : found.sourceStart;
+}
+//==============================================================================
+
+BBPlainText createPlainText( const juce::String& bbText, const juce::Colour& defaultColour )
+{
+    return createPlainText( std::string_view { bbText.toRawUTF8(), bbText.getNumBytesAsUTF8() }, defaultColour );
+}
+//==============================================================================
+
+BBPlainText createPlainText( std::string_view bbText, const juce::Colour& defaultColour )
+{
+    /** Collects the text of the runs, and where it came from. */
+    class PlainTextSink final : public BBCodeParser::Sink
+    {
+    public:
+        PlainTextSink( std::string_view source, BBPlainText& result ) noexcept : m_source( source ), m_result( result ) {}
+
+        void addRun( [[maybe_unused]] juce::uint16 state, [[maybe_unused]] juce::uint8 flags, std::initializer_list<std::string_view> text, size_t tokenOffset ) override
+        {
+            for( const auto& part : text )
+            {
+                if( part.empty() )
+                    continue;
+
+                if( std::less_equal<>()( m_source.data(), part.data() ) && std::less<>()( part.data(), m_source.data() + m_source.size() ) )
+                    copy( part, static_cast<size_t>( part.data() - m_source.data() ) );
+                else
+                    add( part, tokenOffset );
+            }
+        }
+
+    private:
+        std::string_view m_source;
+        BBPlainText&     m_result;
+
+        /** Text that is part of the source. */
+        void copy( std::string_view text, size_t sourceStart )
+        {
+            const auto textStart = m_result.text.size();
+            m_result.text.append( text );
+
+            // Continues the previous segment if nothing was skipped in between...
+            if( !m_result.segments.empty() )
+            {
+                const auto& last = m_result.segments.back();
+                if( last.copied && size_t { last.sourceStart } + ( textStart - last.textStart ) == sourceStart )
+                    return;
+            }
+            m_result.segments.push_back( { static_cast<juce::uint32>( textStart ), static_cast<juce::uint32>( sourceStart ), true } );
+        }
+
+        /** Text added by the token at the given offset. */
+        void add( std::string_view text, size_t tokenOffset )
+        {
+            const auto textStart = m_result.text.size();
+            m_result.text.append( text );
+
+            if( !m_result.segments.empty() )
+            {
+                const auto& last = m_result.segments.back();
+                if( !last.copied && last.sourceStart == tokenOffset )
+                    return;
+            }
+            m_result.segments.push_back( { static_cast<juce::uint32>( textStart ), static_cast<juce::uint32>( tokenOffset ), false } );
+        }
+    };
+
+    BBPlainText result;
+    result.text.reserve( bbText.size() );
+    result.segments.reserve( static_cast<size_t>( std::count( bbText.begin(), bbText.end(), *BBCode::kTokenStart ) ) + 1 );
+
+    BBCodeParser  parser { defaultColour };
+    PlainTextSink sink { bbText, result };
+    parser.parseNext( bbText, sink );
+    return result;
+}
+//==============================================================================
+
+}  // namespace sd
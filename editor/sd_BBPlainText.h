@@ -0,0 +1,67 @@
+/*
+  =====================================================================================================
+
+    sd_BBPlainText.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief The visible text of BBCode, with where every character came from.
+ *
+ * The text is what BBCodeEditor shows, including bullets, quote marks and code
+ * block padding. Segments map it back to the source: every segment either holds
+ * text copied from the source, or text added by a tag (a bullet, quote marks,
+ * padding), which maps to the start of that tag.
+ *
+ * @see createPlainText
+ */
+struct BBPlainText
+{
+    struct Segment
+    {
+        juce::uint32 textStart { 0 };    ///< Offset in bytes into the text.
+        juce::uint32 sourceStart { 0 };  ///< Offset in bytes into the source of the first character, or of the tag that added it.
+        bool         copied { true };    ///< True if the characters were copied from the source one to one.
+    };
+
+    std::string          text;      ///< UTF-8.
+    std::vector<Segment> segments;  ///< Sorted by textStart, the first one starts at zero.
+
+    /**
+     * @brief Get the source offset of a character of the text.
+     *
+     * @param textOffset Offset in bytes into the text.
+     * @return           Offset in bytes into the source of that character, or of the tag that added it.
+     */
+    [[nodiscard]] size_t getSourceOffset( size_t textOffset ) const noexcept;
+};
+
+/**
+ * @brief Extract the visible text of BBCode, without creating any fonts or runs.
+ *
+ * Runs BBCodeParser with a sink that only collects the text, so the text is
+ * exactly what BBCodeEditor would show. Useful to index many documents for search.
+ *
+ * @param bbText        The BBCode formatted text.
+ * @param defaultColour The colour of text without [color] tag. It matters because
+ *                      a [color] tag that does not change the colour is shown as text.
+ * @return              The text and its mapping to the source.
+ */
+[[nodiscard]] BBPlainText createPlainText( std::string_view bbText, const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour } );
+
+/** @copydoc createPlainText(std::string_view,const juce::Colour&) */
+[[nodiscard]] BBPlainText createPlainText( const juce::String& bbText, const juce::Colour& defaultColour = juce::Colour { TextFormatState::kDefaultColour } );
+
+}  // namespace sd
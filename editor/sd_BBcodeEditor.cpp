@@ -14,161 +14,289 @@
 namespace sd
 {
 
-void BBCodeEditor::initialise( )
-{   
+class BBCodeEditor::ParseJob : public juce::ThreadPoolJob
+{
+public:
+    ParseJob( BBCodeEditor& editor, const juce::String& bbText, std::function<void()> onDone )
+      : juce::ThreadPoolJob( "BBCodeEditor parser" )
+      , m_editor( &editor )
+      , m_generation( editor.m_asyncGeneration )
+      , m_bbText( bbText )
+      , m_onDone( std::move( onDone ) )
+    {
+        m_result->parser.reset( editor.getDefaultColour() );
+    }
+
+    JobStatus runJob() override
+    {
+        m_result->document = m_result->parser.parseNext( { m_bbText.toRawUTF8(), m_bbText.getNumBytesAsUTF8() } );
+        if( shouldExit() )
+            return jobHasFinished;
+
+        juce::MessageManager::callAsync( [editor = m_editor, generation = m_generation, result = m_result, onDone = m_onDone]() {
+            // Deleted, or superseded by a newer call...
+            if( editor == nullptr || editor->m_asyncGeneration != generation )
+                return;
+
+            editor->m_parser = std::move( result->parser );
+            editor->forgetSource();
+            editor->initialise();
+            editor->addDocument( result->document );
+
+            if( onDone )
+                onDone();
+        } );
+        return jobHasFinished;
+    }
+
+private:
+    struct Result
+    {
+        BBCodeParser parser;
+        BBDocument   document;
+    };
+
+    juce::Component::SafePointer<BBCodeEditor> m_editor;
+    int                                        m_generation;
+    juce::String                               m_bbText;
+    std::function<void()>                      m_onDone;
+    std::shared_ptr<Result>                    m_result { std::make_shared<Result>() };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( ParseJob )
+};
+//==============================================================================
+
+void BBCodeEditor::initialise()
+{
     setJustification( kDefaultJustification );
-    m_listPrefix  = false;
-    m_quotePrefix = false;
-    m_stateQueue.clear();
-    m_stateQueue.emplace_back( sd::TextFormatState( findColour( juce::TextEditor::textColourId ) ) );
     clear();
 }
 //==============================================================================
 
-void BBCodeEditor::setBBText( const juce::String& bbText )
+void BBCodeEditor::cancelPendingUpdate()
 {
-    initialise();
-
-    auto plainText     = bbText.upToFirstOccurrenceOf( BBCode::kTokenStart, false, false );
-    auto remainingText = bbText.fromFirstOccurrenceOf( BBCode::kTokenStart, false, false );
-    addBBText( plainText );
-
-    while( remainingText.isNotEmpty() )
-    {
-        // Ignore superfluous '['...
-        if( remainingText.startsWith( BBCode::kTokenStart ) )
-        {
-            remainingText = remainingText.substring( 1 );
-            addBBText( BBCode::kTokenStart );
-            continue;
-        }
-
-        // Check for 'quote' tokens...
-        juce::String value {};
-        if( remainingText.startsWith( BBCode::kQuoteToken ) )
-        {
-            value = remainingText.upToFirstOccurrenceOf( BBCode::kTokenEnd, false, false ).fromFirstOccurrenceOf( BBCode::kValueDelimiter, false, false );
-            m_quotePrefix = true;
-        }
+    ++m_asyncGeneration;
+    if( m_threadPool != nullptr )
+        m_threadPool->removeAllJobs( true, 0 );
+}
+//==============================================================================
 
-        // Process lists...
-        bool succesfullyParsed = true;
-        if( remainingText.startsWith( BBCode::kBulletToken ) )
-        {
-            remainingText = remainingText.substring( 1 );
-            m_listPrefix  = true;
-        }
-        else
-        {
-            const auto token = remainingText.upToFirstOccurrenceOf( BBCode::kTokenEnd, false, false );
-
-            if( token.contains( BBCode::kTokenStart ) )
-            {
-                succesfullyParsed = false;
-            }
-            // Parse justification (juce::TextEditor only has global justification)...
-            else if( token.startsWith( BBCode::kAlignToken ) )
-            {
-                parseJustification( token, !token.startsWith( BBCode::kCloseTokenPrefix ) );
-            }
-            // Parse other tokens...
-            else if( auto newState = m_stateQueue.back().withToken( token ) )
-            {
-                // End token pops state...
-                if( token.startsWith( BBCode::kCloseTokenPrefix ) )
-                {
-                    if( m_stateQueue.size() > 1 )
-                        m_stateQueue.pop_back();
-                }
-                // Start token pushes state...
-                else
-                {
-                    m_stateQueue.emplace_back( newState.operator*() );
-                }
-            }
-            else
-            {
-                succesfullyParsed = false;
-            }
-        }
+void BBCodeEditor::forgetSource()
+{
+    m_source = {};
+    m_checkpoints.clear();
+    m_checkpointPositions.clear();
+}
+//==============================================================================
 
-        // Assemble plain text to be added to the editor...
-        if( succesfullyParsed )
-            plainText = remainingText.fromFirstOccurrenceOf( BBCode::kTokenEnd, false, false ).upToFirstOccurrenceOf( BBCode::kTokenStart, false, false );
-        else
-            plainText = BBCode::kTokenStart + remainingText.upToFirstOccurrenceOf( BBCode::kTokenStart, false, false );
+size_t BBCodeEditor::findCheckpoint( std::string_view source ) const
+{
+    // Checkpoints only hold while the editor shows what they were rendered into...
+    if( m_checkpoints.empty() || getDefaultColour() != m_sourceColour || getTotalNumChars() != m_sourceNumChars )
+        return m_checkpoints.size();
 
-        // Trailing newlines for CODE blocks...
-        if( remainingText.startsWith( BBCode::kCodeToken ) )
-            plainText = juce::newLine + juce::newLine + kTabCharacter + plainText + juce::newLine + juce::newLine;
+    const std::string_view previous { m_source.toRawUTF8(), m_source.getNumBytesAsUTF8() };
+    const auto             commonLength = static_cast<size_t>(
+        std::mismatch( previous.begin(), previous.end(), source.begin(), source.end() ).first - previous.begin() );
 
-        addBBText( plainText, value );
+    // The last checkpoint that does not depend on anything that changed...
+    const auto unchanged = std::partition_point( m_checkpoints.begin(), m_checkpoints.end(), [commonLength]( const auto& checkpoint ) {
+        return checkpoint.sourceDependency <= commonLength;
+    } );
+    return unchanged == m_checkpoints.begin() ? m_checkpoints.size() : static_cast<size_t>( unchanged - m_checkpoints.begin() ) - 1;
+}
+//==============================================================================
 
-        // Progress the parser....
-        remainingText = remainingText.fromFirstOccurrenceOf( BBCode::kTokenStart, false, false );
-    }
+void BBCodeEditor::removeFrom( int position )
+{
+    const auto wasReadOnly = isReadOnly();
+    setReadOnly( true );
+    setHighlightedRegion( { position, getTotalNumChars() } );
+    insertTextAtCaret( {} );
+    setReadOnly( wasReadOnly );
 }
 //==============================================================================
 
-void BBCodeEditor::addBBText( const juce::String& text, const juce::String& value /*= {}*/ )
+void BBCodeEditor::setBBText( const juce::String& bbText )
 {
-    if( text.isEmpty() )
-        return;
+    cancelPendingUpdate();
 
-    sd::TextFormatState textFormatState { findColour( juce::TextEditor::textColourId ) };  // Default state.
-    if( !m_stateQueue.empty() )
-        textFormatState = m_stateQueue.back();
+    const std::string_view                        source { bbText.toRawUTF8(), bbText.getNumBytesAsUTF8() };
+    size_t                                        offset { 0 };
+    std::shared_ptr<const BBDocumentCache::Entry> cached;
 
-    setColour( juce::TextEditor::textColourId, textFormatState.getColour() );
-    setFont( textFormatState.getFont() );
-    moveCaretToEnd();
-    
-    // Add quote...
-    if( m_quotePrefix )
+    if( const auto checkpoint = findCheckpoint( source ); checkpoint < m_checkpoints.size() )
     {
-        insertTextAtCaret( juce::newLine + juce::newLine + "|" + kTabCharacter );
-        if( value.isNotEmpty() )
-        {
-            const auto previousFont = getFont();
-            const auto wasBold      = previousFont.isBold();
-            setFont( previousFont.boldened() );
-            insertTextAtCaret( value + ": " );
-            if( !wasBold )
-                setFont( previousFont.withStyle( previousFont.getStyleFlags() & ~juce::Font::bold ) );  // NOLINT
-        }
-        insertTextAtCaret( juce::String::fromUTF8( kOpenQuotes ) + text + juce::String::fromUTF8( kCloseQuotes ) );
+        // Keep everything before the checkpoint...
+        m_checkpoints.resize( checkpoint + 1 );
+        m_checkpointPositions.resize( checkpoint + 1 );
+        m_parser.restore( m_checkpoints.back() );
+        removeFrom( m_checkpointPositions.back() );
+        offset = m_checkpoints.back().sourceOffset;
+    }
+    else
+    {
+        forgetSource();
+        m_sourceColour = getDefaultColour();
+        m_parser.reset( m_sourceColour );
+        initialise();
+
+        // Keyed on the default colour, textColourId only holds it while no document is added...
+        if( m_documentCache != nullptr )
+            cached = m_documentCache->find( bbText, m_sourceColour );
     }
-    // Add bullet list item...
-    else if( m_listPrefix )
+
+    if( cached != nullptr )
     {
-        insertTextAtCaret( juce::String::fromUTF8( kBulletCharacter ) + kTabCharacter + text );
+        // Parsed before, only the editor needs filling...
+        m_checkpoints = cached->checkpoints;
+        m_parser.restore( cached->endState );
+        addDocument( cached->document, 0 );
     }
-    // Add plain text...
     else
     {
-        insertTextAtCaret( text );
+        const auto firstCheckpoint = m_checkpoints.size();
+        auto       document        = m_parser.parseNext( source.substr( offset ), &m_checkpoints );
+        for( auto checkpoint = firstCheckpoint; checkpoint < m_checkpoints.size(); ++checkpoint )
+        {
+            m_checkpoints[checkpoint].sourceOffset += offset;
+            m_checkpoints[checkpoint].sourceDependency += offset;
+        }
+
+        addDocument( document, firstCheckpoint );
+
+        if( m_documentCache != nullptr && offset == 0 )
+            m_documentCache->add( bbText, m_sourceColour, std::make_shared<const BBDocumentCache::Entry>( BBDocumentCache::Entry { std::move( document ), m_checkpoints, m_parser.getCheckpoint() } ) );
     }
-    m_listPrefix  = false;
-    m_quotePrefix = false;
+
+    m_source         = bbText;
+    m_sourceNumChars = getTotalNumChars();
 }
 //==============================================================================
 
-void BBCodeEditor::parseJustification( const juce::String& token, bool enable )
+juce::Colour BBCodeEditor::getDefaultColour() const
 {
-    m_justification = kDefaultJustification;
-    if( enable )
+    // Not set on the editor, it comes from the look and feel...
+    return m_defaultColour.value_or( findColour( juce::TextEditor::textColourId ) );
+}
+//==============================================================================
+
+void BBCodeEditor::colourChanged()
+{
+    if( !m_isAddingDocument )
+        m_defaultColour = findColour( juce::TextEditor::textColourId );
+
+    juce::TextEditor::colourChanged();
+}
+//==============================================================================
+
+void BBCodeEditor::setDocumentCache( BBDocumentCache* cache ) noexcept
+{
+    m_documentCache = cache;
+}
+//==============================================================================
+
+void BBCodeEditor::appendBBText( const juce::String& bbText )
+{
+    forgetSource();
+    addDocument( m_parser.parseNext( { bbText.toRawUTF8(), bbText.getNumBytesAsUTF8() } ) );
+}
+//==============================================================================
+
+void BBCodeEditor::setBBTextAsync( const juce::String& bbText, std::function<void()> onDone )
+{
+    cancelPendingUpdate();
+
+    if( m_threadPool == nullptr )
+        m_threadPool = std::make_unique<juce::ThreadPool>( 1 );
+
+    m_threadPool->addJob( new ParseJob( *this, bbText, std::move( onDone ) ), true );
+}
+//==============================================================================
+
+bool BBCodeEditor::setCompiledBBText( const void* data, size_t numBytes )
+{
+    const CompiledBBDocument document { data, numBytes };
+    if( !document.isValid() )
+        return false;
+
+    cancelPendingUpdate();
+    forgetSource();
+    m_parser.reset( getDefaultColour() );
+    initialise();
+    addDocument( document );
+    return true;
+}
+//==============================================================================
+
+void BBCodeEditor::setBBDocument( const BBDocument& document )
+{
+    cancelPendingUpdate();
+    forgetSource();
+    m_parser.reset( getDefaultColour() );
+    initialise();
+    addDocument( document );
+}
+//==============================================================================
+
+template <typename Document>
+void BBCodeEditor::addDocument( const Document& document, size_t firstCheckpoint )
+{
+#if BBCODE_EDITOR_ENABLE_STATS
+    m_lastParseStats         = m_parser.getLastParseStats();
+    m_lastParseStats.numRuns = document.getNumRuns();
+    const ParseStats::ScopedTimer commitTimer { m_lastParseStats.commitSeconds };
+#endif
+
+    // Runs are inserted in the text colour of their state, the default colour is put back afterwards...
+    const auto                          defaultColour = getDefaultColour();
+    const juce::ScopedValueSetter<bool> addingDocument { m_isAddingDocument, true };
+
+    // A read-only TextEditor has no undo manager, so nothing of this ends up in the undo history...
+    const auto wasReadOnly = isReadOnly();
+    setReadOnly( true );
+    moveCaretToEnd();
+
+    const auto numRuns    = document.getNumRuns();
+    auto       checkpoint = std::min( firstCheckpoint, m_checkpoints.size() );
+    for( size_t first = 0; first < numRuns; )
     {
-        if( token.endsWithIgnoreCase( "right" ) )
-            m_justification = juce::Justification::topRight;
-        else if( token.endsWithIgnoreCase( "center" ) )
-            m_justification = juce::Justification::centredTop;
-        else if( token.endsWithIgnoreCase( "justify" ) )
-            m_justification = juce::Justification::horizontallyJustified;
-        else
-            m_justification = juce::Justification::topLeft;
+        // Remember where the checkpoints end up, the caret is always at the end...
+        for( ; checkpoint < m_checkpoints.size() && m_checkpoints[checkpoint].runIndex <= first; ++checkpoint )
+            m_checkpointPositions.push_back( getCaretPosition() );
+
+        // Consecutive runs with the same format state are contiguous in the text and become one section.
+        // A checkpoint always starts a new one, so the text can be cut there...
+        const auto end      = checkpoint < m_checkpoints.size() ? m_checkpoints[checkpoint].runIndex : numRuns;
+        const auto firstRun = document.getRun( first );
+        auto       lastRun  = firstRun;
+        auto       last     = first + 1;
+        for( ; last < end && document.getRun( last ).state == firstRun.state; ++last )
+            lastRun = document.getRun( last );
+
+        const auto textFormatState = document.getState( firstRun );
+        if( findColour( juce::TextEditor::textColourId ) != textFormatState.getColour() )
+            setColour( juce::TextEditor::textColourId, textFormatState.getColour() );
+        if( const auto font = textFormatState.getFont(); font != getFont() )
+            setFont( font );
+        BBCODE_STATS( ++m_lastParseStats.numFontLookups; )
+
+        const auto offset = firstRun.offset;
+        const auto length = lastRun.offset + lastRun.length - offset;
+        insertTextAtCaret( BBCodeTokenizer::toString( document.getText().substr( offset, length ) ) );
+
+        first = last;
     }
 
-    setJustification( m_justification );
+    for( ; checkpoint < m_checkpoints.size(); ++checkpoint )
+        m_checkpointPositions.push_back( getCaretPosition() );
+
+    if( findColour( juce::TextEditor::textColourId ) != defaultColour )
+        setColour( juce::TextEditor::textColourId, defaultColour );
+
+    setReadOnly( wasReadOnly );
+    setJustification( document.getJustification() );
+    repaint();
 }
 
 }  // namespace sd
@@ -21,24 +21,137 @@ class BBCodeEditor : public juce::TextEditor
 {
 public:
     static constexpr auto kDefaultJustification { juce::Justification::topLeft };
-    static constexpr auto kBulletCharacter { u8"\u2022" };
-    static constexpr auto kOpenQuotes { u8"\u201C" };
-    static constexpr auto kCloseQuotes { u8"\u201D" };
-    static constexpr auto kTabCharacter { "    " };
+    static constexpr auto kBulletCharacter { BBCode::kBulletCharacter };
+    static constexpr auto kOpenQuotes { BBCode::kOpenQuotes };
+    static constexpr auto kCloseQuotes { BBCode::kCloseQuotes };
+    static constexpr auto kTabCharacter { BBCode::kTabCharacter };
 
     using juce::TextEditor::TextEditor;
 
+    /**
+     * @brief Replace the content of the editor with BBCode formatted text.
+     *
+     * When only the end of the text changed since the previous call, e.g. a
+     * growing log or a status line, the unchanged start is kept: parsing resumes
+     * at the last checkpoint before the first change and only what follows it is
+     * re-rendered. The result is the same as rendering from scratch.
+     *
+     * That only works while the content is changed through setBBText alone.
+     * After appendBBText, setBBTextAsync, setBBDocument, an edit by the user or a
+     * change of the text colour the next call renders everything again.
+     *
+     * @param bbText The BBCode formatted text.
+     */
     void setBBText( const juce::String& bbText );
 
+    /**
+     * @brief Add BBCode formatted text at the end of the editor.
+     *
+     * Only the new text is parsed. Tags left open, list/quote prefixes and
+     * justification carry over from the text set or appended before.
+     *
+     * @param bbText The BBCode formatted text to add.
+     *
+     * @see setBBText
+     */
+    void appendBBText( const juce::String& bbText );
+
+    /**
+     * @brief Parse BBCode on a background thread and show it when done.
+     *
+     * Tokenizing and resolving formats happen on a worker thread, the result is
+     * committed on the message thread and looks exactly like setBBText would.
+     * A newer call, or a call to setBBText or setBBDocument, cancels a pending one.
+     *
+     * @param bbText The BBCode formatted text.
+     * @param onDone Called on the message thread once the text is shown. Not called when cancelled.
+     *
+     * @see setBBText
+     */
+    void setBBTextAsync( const juce::String& bbText, std::function<void()> onDone = nullptr );
+
+    /**
+     * @brief Replace the content of the editor with a parsed document.
+     *
+     * Text appended afterwards starts without any open tags.
+     *
+     * @param document The document, as parsed by BBCodeParser.
+     *
+     * @see setBBText
+     */
+    void setBBDocument( const BBDocument& document );
+
+    /**
+     * @brief Replace the content of the editor with compiled BBCode.
+     *
+     * The blob is read in place, nothing is tokenized. Text appended afterwards
+     * starts without any open tags.
+     *
+     * @param data     The blob, as created by CompiledBBDocument::compile or the BBCodeCompiler tool.
+     * @param numBytes The size of the blob.
+     * @return         False if the blob is damaged or of another format version, the editor is left untouched then.
+     *
+     * @see CompiledBBDocument
+     */
+    bool setCompiledBBText( const void* data, size_t numBytes );
+
+    /**
+     * @brief Use a cache of parsed documents.
+     *
+     * setBBText then skips parsing for text it was given before, with the same default colour (see getDefaultColour).
+     * Several editors can share one cache.
+     *
+     * @param cache The cache, or nullptr to parse everything again. Not owned, must outlive the editor.
+     */
+    void setDocumentCache( BBDocumentCache* cache ) noexcept;
+
+    /**
+     * @brief Get the colour of text without [color] tag.
+     *
+     * That is the text colour (juce::TextEditor::textColourId) of the editor. Inserting
+     * formatted text changes the text colour for a moment, this is the colour it was set to.
+     */
+    [[nodiscard]] juce::Colour getDefaultColour() const;
+
+    /** @internal */
+    void colourChanged() override;
+
+#if BBCODE_EDITOR_ENABLE_STATS
+    /**
+     * @brief Get the statistics of the last update.
+     *
+     * Covers the last setBBText, appendBBText, setBBTextAsync or setBBDocument
+     * call that made it into the editor. setBBDocument only has commit statistics.
+     */
+    [[nodiscard]] const ParseStats& getLastParseStats() const noexcept { return m_lastParseStats; }
+#endif
+
 private:
-    std::vector<sd::TextFormatState> m_stateQueue;
-    bool                             m_listPrefix { false };
-    bool                             m_quotePrefix { false };
-    juce::Justification              m_justification { kDefaultJustification };
-
-    void initialise();
-    void addBBText( const juce::String& text, const juce::String& value = {} );
-    void parseJustification( const juce::String& justification, bool enable );
+    class ParseJob;
+
+    BBCodeParser                      m_parser;
+    BBDocumentCache*                  m_documentCache { nullptr };
+    std::unique_ptr<juce::ThreadPool> m_threadPool;
+    int                               m_asyncGeneration { 0 };
+    std::optional<juce::Colour>       m_defaultColour;  // The text colour as set on the editor, not by addDocument.
+    bool                              m_isAddingDocument { false };
+    BBCODE_STATS( ParseStats m_lastParseStats; )
+
+    // What setBBText rendered last, to re-render only what changes...
+    juce::String                          m_source;
+    juce::Colour                          m_sourceColour;
+    int                                   m_sourceNumChars { 0 };
+    std::vector<BBCodeParser::Checkpoint> m_checkpoints;
+    std::vector<int>                      m_checkpointPositions;  // Character index in the editor of every checkpoint.
+
+    void   initialise();
+    void   cancelPendingUpdate();
+    void   forgetSource();
+    size_t findCheckpoint( std::string_view source ) const;
+    void   removeFrom( int position );
+
+    template <typename Document>
+    void addDocument( const Document& document, size_t firstCheckpoint = std::numeric_limits<size_t>::max() );
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR( BBCodeEditor )
 };
@@ -0,0 +1,206 @@
+/*
+  =====================================================================================================
+
+    sd_CompiledBBDocument.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+CompiledBBDocument::CompiledBBDocument( const void* data, size_t numBytes )
+{
+    m_valid = data != nullptr && open( static_cast<const char*>( data ), numBytes );
+}
+//==============================================================================
+
+BBDocument::Run CompiledBBDocument::getRun( size_t index ) const noexcept
+{
+    jassert( index < m_numRuns );
+
+    return readRun( m_runs + index * kRunSize );
+}
+//==============================================================================
+
+BBDocument::Run CompiledBBDocument::readRun( const char* run ) noexcept
+{
+    BBDocument::Run result;
+    result.offset    = juce::ByteOrder::littleEndianInt( run );
+    result.length    = juce::ByteOrder::littleEndianInt( run + 4 );
+    result.state     = juce::ByteOrder::littleEndianShort( run + 8 );
+    result.flags     = static_cast<juce::uint8>( run[10] );
+    result.alignment = static_cast<BBDocument::Alignment>( run[11] );
+    return result;
+}
+//==============================================================================
+
+TextFormatState CompiledBBDocument::getState( const BBDocument::Run& run ) const noexcept
+{
+    jassert( m_valid && run.state < m_numStates );
+
+    const auto* state      = m_states + run.state * kStateSize;
+    const auto  heightBits = juce::ByteOrder::littleEndianInt( state );
+    const auto  typeface   = juce::ByteOrder::littleEndianShort( state + 8 );
+    float       height { 0.0F };
+    std::memcpy( &height, &heightBits, sizeof( height ) );
+
+    return { height,
+             juce::Colour { juce::ByteOrder::littleEndianInt( state + 4 ) },
+             typeface == kDefaultTypeface ? TypefaceNameCache::kDefaultTypeface : m_typefaceIds[typeface],
+             static_cast<juce::uint8>( state[10] ) };
+}
+//==============================================================================
+
+bool CompiledBBDocument::open( const char* data, size_t numBytes )
+{
+    if( numBytes < kHeaderSize || std::memcmp( data, kMagic, sizeof( kMagic ) ) != 0 )
+        return false;
+
+    if( juce::ByteOrder::littleEndianShort( data + 4 ) != kVersion )
+        return false;
+
+    const auto alignment         = static_cast<juce::uint8>( data[6] );
+    const auto numStates         = size_t { juce::ByteOrder::littleEndianInt( data + 8 ) };
+    const auto numRuns           = size_t { juce::ByteOrder::littleEndianInt( data + 12 ) };
+    const auto numTypefaces      = size_t { juce::ByteOrder::littleEndianInt( data + 16 ) };
+    const auto typefaceNamesSize = size_t { juce::ByteOrder::littleEndianInt( data + 20 ) };
+    const auto textSize          = size_t { juce::ByteOrder::littleEndianInt( data + 24 ) };
+
+    if( alignment > static_cast<juce::uint8>( BBDocument::Alignment::justify ) )
+        return false;
+
+    // All counts are 32 bit, so in 64 bit this can not overflow...
+    const auto typefacesStart = juce::uint64 { kHeaderSize } + juce::uint64 { numStates } * kStateSize + juce::uint64 { numRuns } * kRunSize;
+    const auto namesStart     = typefacesStart + juce::uint64 { numTypefaces } * kTypefaceSize;
+    const auto textStart      = namesStart + typefaceNamesSize;
+    if( textStart + textSize != numBytes )
+        return false;
+
+    const auto* states = data + kHeaderSize;
+    const auto* runs   = states + numStates * kStateSize;
+
+    for( size_t index = 0; index < numStates; ++index )
+    {
+        const auto typeface = juce::ByteOrder::littleEndianShort( states + index * kStateSize + 8 );
+        if( typeface != kDefaultTypeface && typeface >= numTypefaces )
+            return false;
+    }
+
+    for( size_t index = 0; index < numRuns; ++index )
+    {
+        const auto run = readRun( runs + index * kRunSize );
+        if( run.state >= numStates || size_t { run.offset } + run.length > textSize || run.alignment > BBDocument::Alignment::justify )
+            return false;
+    }
+
+    // Resolve the requested font families on this machine...
+    auto&                     typefaces = TypefaceNameCache::getInstance();
+    std::vector<juce::uint16> typefaceIds;
+    typefaceIds.reserve( numTypefaces );
+    for( size_t index = 0; index < numTypefaces; ++index )
+    {
+        const auto* typeface = data + typefacesStart + index * kTypefaceSize;
+        const auto  offset   = size_t { juce::ByteOrder::littleEndianInt( typeface ) };
+        const auto  length   = size_t { juce::ByteOrder::littleEndianInt( typeface + 4 ) };
+        if( offset + length > typefaceNamesSize )
+            return false;
+
+        typefaceIds.push_back( typefaces.getTypefaceId( { data + namesStart + offset, length } ) );
+    }
+
+    // Only a blob that passed every check is read from...
+    m_alignment   = static_cast<BBDocument::Alignment>( alignment );
+    m_states      = states;
+    m_runs        = runs;
+    m_numStates   = numStates;
+    m_numRuns     = numRuns;
+    m_text        = { data + textStart, textSize };
+    m_typefaceIds = std::move( typefaceIds );
+    return true;
+}
+//==============================================================================
+
+juce::MemoryBlock CompiledBBDocument::compile( const BBDocument& document )
+{
+    // Typeface ids only mean something in this process, and resolved names only on this machine.
+    // The names are stored as requested, to be resolved where the blob is opened...
+    std::vector<juce::uint16> typefaceIds;
+    std::string               typefaceNames;
+    std::vector<juce::uint16> stateTypefaces;
+    for( size_t index = 0; index < document.getNumStates(); ++index )
+    {
+        const auto typefaceId = document.getState( index ).getTypefaceId();
+        if( typefaceId == TypefaceNameCache::kDefaultTypeface )
+        {
+            stateTypefaces.push_back( kDefaultTypeface );
+            continue;
+        }
+
+        auto typeface = std::find( typefaceIds.begin(), typefaceIds.end(), typefaceId );
+        if( typeface == typefaceIds.end() )
+        {
+            typefaceIds.push_back( typefaceId );
+            typefaceNames.append( TypefaceNameCache::getInstance().getRequestedName( typefaceId ).toStdString() ).push_back( '\0' );
+            typeface = std::prev( typefaceIds.end() );
+        }
+        stateTypefaces.push_back( static_cast<juce::uint16>( typeface - typefaceIds.begin() ) );
+    }
+
+    juce::MemoryBlock        block;
+    juce::MemoryOutputStream stream { block, false };
+
+    stream.write( kMagic, sizeof( kMagic ) );
+    stream.writeShort( static_cast<short>( kVersion ) );
+    stream.writeByte( static_cast<char>( document.getAlignment() ) );
+    stream.writeByte( 0 );
+    stream.writeInt( static_cast<int>( document.getNumStates() ) );
+    stream.writeInt( static_cast<int>( document.getRuns().size() ) );
+    stream.writeInt( static_cast<int>( typefaceIds.size() ) );
+    stream.writeInt( static_cast<int>( typefaceNames.size() ) );
+    stream.writeInt( static_cast<int>( document.getText().size() ) );
+    stream.writeInt( 0 );
+
+    for( size_t index = 0; index < document.getNumStates(); ++index )
+    {
+        const auto& state = document.getState( index );
+        stream.writeFloat( state.getFontHeight() );
+        stream.writeInt( static_cast<int>( state.getColour().getARGB() ) );
+        stream.writeShort( static_cast<short>( stateTypefaces[index] ) );
+        stream.writeByte( static_cast<char>( state.getStyleFlags() ) );
+        stream.writeByte( 0 );
+    }
+
+    for( const auto& run : document.getRuns() )
+    {
+        stream.writeInt( static_cast<int>( run.offset ) );
+        stream.writeInt( static_cast<int>( run.length ) );
+        stream.writeShort( static_cast<short>( run.state ) );
+        stream.writeByte( static_cast<char>( run.flags ) );
+        stream.writeByte( static_cast<char>( run.alignment ) );
+    }
+
+    // Names are stored null terminated, the terminator is not part of the length...
+    for( size_t offset = 0; offset < typefaceNames.size(); offset = typefaceNames.find( '\0', offset ) + 1 )
+    {
+        stream.writeInt( static_cast<int>( offset ) );
+        stream.writeInt( static_cast<int>( typefaceNames.find( '\0', offset ) - offset ) );
+    }
+
+    stream.write( typefaceNames.data(), typefaceNames.size() );
+    stream.write( document.getText().data(), document.getText().size() );
+    stream.flush();
+
+    return block;
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,102 @@
+/*
+  =====================================================================================================
+
+    sd_CompiledBBDocument.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Parsed BBCode in a compact binary form, read in place.
+ *
+ * compile() turns a BBDocument into a blob, e.g. offline with the BBCodeCompiler
+ * tool so the result can be embedded with BinaryData. Reading a blob never
+ * tokenizes and never copies it: runs and text are read straight from the
+ * memory, which must outlive this object. Font families are stored as written
+ * in the BBCode ([font=...], or the monospace family of [code]) and resolved when
+ * the blob is opened, since that depends on the fonts of the machine. Families
+ * that resolved to the same typeface while compiling are stored as the first one.
+ *
+ * Layout (version 1, little endian, no alignment requirements):
+ * @code
+ * header   "SDBB", uint16 version, uint8 alignment, uint8 reserved,
+ *          uint32 numStates, numRuns, numTypefaces, typefaceNamesSize, textSize, reserved
+ * states   numStates    x { float height, uint32 argb, uint16 typeface, uint8 style, uint8 reserved }
+ * runs     numRuns      x { uint32 offset, uint32 length, uint16 state, uint8 flags, uint8 alignment }
+ * fonts    numTypefaces x { uint32 offset, uint32 length }  (into the typeface names)
+ * typeface names, UTF-8, as requested (see TypefaceNameCache::getRequestedName)
+ * text, UTF-8
+ * @endcode
+ * A typeface index of 0xffff is the default typeface.
+ *
+ * @see BBCodeEditor::setCompiledBBText
+ */
+class CompiledBBDocument
+{
+public:
+    static constexpr juce::uint16 kVersion { 1 };
+    static constexpr char         kMagic[] { 'S', 'D', 'B', 'B' };
+
+    /**
+     * @brief Open a compiled blob.
+     *
+     * @param data     The blob, as created by compile().
+     * @param numBytes The size of the blob.
+     *
+     * @see isValid
+     */
+    CompiledBBDocument( const void* data, size_t numBytes );
+
+    /** @brief Check whether the blob is complete, consistent and of the current version. */
+    [[nodiscard]] bool isValid() const noexcept { return m_valid; }
+
+    [[nodiscard]] size_t           getNumRuns() const noexcept { return m_numRuns; }
+    [[nodiscard]] BBDocument::Run  getRun( size_t index ) const noexcept;
+    [[nodiscard]] std::string_view getText() const noexcept { return m_text; }
+    [[nodiscard]] std::string_view getText( const BBDocument::Run& run ) const noexcept { return m_text.substr( run.offset, run.length ); }
+    [[nodiscard]] TextFormatState  getState( const BBDocument::Run& run ) const noexcept;
+
+    /** @copydoc BBDocument::getJustification */
+    [[nodiscard]] juce::Justification getJustification() const noexcept { return BBDocument::toJustification( m_alignment ); }
+
+    /**
+     * @brief Serialise a parsed document.
+     *
+     * @param document The document, as parsed by BBCodeParser.
+     * @return         The blob, to be opened with CompiledBBDocument.
+     */
+    [[nodiscard]] static juce::MemoryBlock compile( const BBDocument& document );
+
+private:
+    static constexpr size_t       kHeaderSize { 32 };
+    static constexpr size_t       kStateSize { 12 };
+    static constexpr size_t       kRunSize { 12 };
+    static constexpr size_t       kTypefaceSize { 8 };
+    static constexpr juce::uint16 kDefaultTypeface { 0xffff };
+
+    const char*               m_states { nullptr };
+    const char*               m_runs { nullptr };
+    size_t                    m_numStates { 0 };
+    size_t                    m_numRuns { 0 };
+    std::string_view          m_text;
+    std::vector<juce::uint16> m_typefaceIds;  // TypefaceNameCache ids of the typeface table.
+    BBDocument::Alignment     m_alignment { BBDocument::Alignment::left };
+    bool                      m_valid { false };
+
+    bool open( const char* data, size_t numBytes );
+
+    static BBDocument::Run readRun( const char* run ) noexcept;
+};
+
+}  // namespace sd
@@ -0,0 +1,111 @@
+/*
+  =====================================================================================================
+
+    sd_FontCache.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+FontCache& FontCache::getInstance()
+{
+    static FontCache instance;
+    return instance;
+}
+//==============================================================================
+
+juce::Font FontCache::getFont( juce::uint16 typefaceId, float height, int styleFlags )
+{
+    const auto key = makeKey( typefaceId, height, styleFlags );
+
+    {
+        const juce::ScopedReadLock lock( m_lock );
+
+        if( const auto entry = m_entries.find( key ); entry != m_entries.end() )
+        {
+            ++m_hits;
+            entry->second.lastUsed = ++m_clock;
+            return entry->second.font;
+        }
+    }
+
+    const juce::ScopedWriteLock lock( m_lock );
+
+    // Another thread may have added it in the meantime...
+    auto entry = m_entries.find( key );
+    if( entry == m_entries.end() )
+    {
+        ++m_misses;
+        entry = m_entries.try_emplace( key, createFont( typefaceId, height, styleFlags ), ++m_clock ).first;
+        evict();
+    }
+    return entry->second.font;
+}
+//==============================================================================
+
+void FontCache::setCapacity( size_t capacity )
+{
+    const juce::ScopedWriteLock lock( m_lock );
+
+    m_capacity = std::max( capacity, size_t { 1 } );
+    evict();
+}
+//==============================================================================
+
+FontCache::Statistics FontCache::getStatistics() const
+{
+    const juce::ScopedReadLock lock( m_lock );
+    return { m_hits, m_misses, m_entries.size(), m_capacity };
+}
+//==============================================================================
+
+void FontCache::clear()
+{
+    const juce::ScopedWriteLock lock( m_lock );
+    m_entries.clear();
+    m_hits   = 0;
+    m_misses = 0;
+}
+//==============================================================================
+
+void FontCache::evict()
+{
+    // The cache is small, finding the oldest entry is cheaper than keeping them ordered...
+    while( m_entries.size() > m_capacity )
+    {
+        const auto oldest = std::min_element( m_entries.begin(), m_entries.end(), []( const auto& a, const auto& b ) {
+            return a.second.lastUsed.load( std::memory_order_relaxed ) < b.second.lastUsed.load( std::memory_order_relaxed );
+        } );
+        m_entries.erase( oldest );
+    }
+}
+//==============================================================================
+
+FontCache::Key FontCache::makeKey( juce::uint16 typefaceId, float height, int styleFlags ) noexcept
+{
+    juce::uint32 heightBits { 0 };
+    std::memcpy( &heightBits, &height, sizeof( heightBits ) );
+    return ( Key { typefaceId } << 40 ) | ( Key { static_cast<juce::uint8>( styleFlags ) } << 32 ) | Key { heightBits };
+}
+//==============================================================================
+
+juce::Font FontCache::createFont( juce::uint16 typefaceId, float height, int styleFlags )
+{
+    if( typefaceId != TypefaceNameCache::kDefaultTypeface )
+        return juce::Font( TypefaceNameCache::getInstance().getTypefaceName( typefaceId ), height, styleFlags );
+
+    return juce::Font().withHeight( height ).withStyle( styleFlags );
+}
+//==============================================================================
+
+}  // namespace sd
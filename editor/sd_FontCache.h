@@ -0,0 +1,94 @@
+/*
+  =====================================================================================================
+
+    sd_FontCache.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Process wide cache of fonts, keyed by typeface, height and style.
+ *
+ * Formatted documents use only a handful of distinct fonts. Reusing the
+ * juce::Font objects means their typefaces are resolved once, instead of
+ * once per run of text. The least recently used font is dropped when the
+ * cache is full.
+ *
+ * All functions are thread safe. Lookups of cached fonts only take a read
+ * lock, so threads converting text in parallel do not wait for each other.
+ *
+ * @see TextFormatState::getFont
+ */
+class FontCache
+{
+public:
+    static constexpr size_t kDefaultCapacity { 64 };
+
+    struct Statistics
+    {
+        juce::uint64 hits { 0 };
+        juce::uint64 misses { 0 };
+        size_t       size { 0 };
+        size_t       capacity { 0 };
+    };
+
+    /** @brief Get the process wide instance. */
+    static FontCache& getInstance();
+
+    /**
+     * @brief Get a font, creating it if it is not cached.
+     *
+     * @param typefaceId The typeface id, see TypefaceNameCache.
+     * @param height     The font height.
+     * @param styleFlags The juce::Font::FontStyleFlags.
+     */
+    [[nodiscard]] juce::Font getFont( juce::uint16 typefaceId, float height, int styleFlags );
+
+    /** @brief Set the maximum number of fonts kept. */
+    void setCapacity( size_t capacity );
+
+    /** @brief Get the hit and miss counts, and the current and maximum size. */
+    [[nodiscard]] Statistics getStatistics() const;
+
+    /** @brief Drop all fonts and reset the hit and miss counts. */
+    void clear();
+
+private:
+    using Key = juce::uint64;
+
+    struct Entry
+    {
+        explicit Entry( const juce::Font& newFont, juce::uint64 time ) : font( newFont ), lastUsed( time ) {}
+
+        juce::Font                font;
+        std::atomic<juce::uint64> lastUsed;  // Updated under the read lock.
+    };
+
+    juce::ReadWriteLock            m_lock;
+    std::unordered_map<Key, Entry> m_entries;
+    size_t                         m_capacity { kDefaultCapacity };
+    std::atomic<juce::uint64>      m_clock { 0 };  // Ticks on every lookup, for finding the least recently used entry.
+    std::atomic<juce::uint64>      m_hits { 0 };
+    std::atomic<juce::uint64>      m_misses { 0 };
+
+    FontCache() = default;
+
+    void              evict();
+    static Key        makeKey( juce::uint16 typefaceId, float height, int styleFlags ) noexcept;
+    static juce::Font createFont( juce::uint16 typefaceId, float height, int styleFlags );
+
+    JUCE_DECLARE_NON_COPYABLE( FontCache )
+};
+
+}  // namespace sd
@@ -0,0 +1,54 @@
+/*
+  =====================================================================================================
+
+    sd_FormatStateTable.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+juce::uint16 FormatStateTable::intern( const TextFormatState& state )
+{
+    if( const auto existing = m_indices.find( state ); existing != m_indices.end() )
+        return existing->second;
+
+    if( m_states.size() >= kMaxNumStates )
+        return kNoState;
+
+    const auto index = static_cast<juce::uint16>( m_states.size() );
+    m_states.push_back( state );
+    m_indices.emplace( state, index );
+    return index;
+}
+//==============================================================================
+
+void FormatStateTable::clear() noexcept
+{
+    m_states.clear();
+    m_indices.clear();
+}
+//==============================================================================
+
+size_t FormatStateTable::Hash::operator()( const TextFormatState& state ) const noexcept
+{
+    juce::uint32 heightBits { 0 };
+    const auto   height = state.getFontHeight();
+    std::memcpy( &heightBits, &height, sizeof( heightBits ) );
+
+    const auto bits = ( juce::uint64 { state.getColour().getARGB() } << 32 ) ^ ( juce::uint64 { state.getTypefaceId() } << 8 )
+                      ^ static_cast<juce::uint64>( state.getStyleFlags() ) ^ ( juce::uint64 { heightBits } * 0x9e3779b97f4a7c15ULL );
+    return std::hash<juce::uint64> {}( bits );
+}
+//==============================================================================
+
+}  // namespace sd
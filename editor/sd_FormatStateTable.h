@@ -0,0 +1,59 @@
+/*
+  =====================================================================================================
+
+    sd_FormatStateTable.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Hash-consed table of format states.
+ *
+ * Every distinct state is stored once and referred to by a 16 bit index, so
+ * two indices from the same table are equal exactly when their states are.
+ *
+ * @see BBCodeParser
+ */
+class FormatStateTable
+{
+public:
+    /** The maximum number of states, one index is kept free as 'no state'. */
+    static constexpr size_t       kMaxNumStates { 0xffff };
+    static constexpr juce::uint16 kNoState { 0xffff };
+
+    /**
+     * @brief Get the index of a state, adding it if it is new.
+     *
+     * @param state The state.
+     * @return      Its index, or kNoState if the table is full.
+     */
+    [[nodiscard]] juce::uint16 intern( const TextFormatState& state );
+
+    [[nodiscard]] const TextFormatState& getState( juce::uint16 index ) const noexcept { return m_states[index]; }
+    [[nodiscard]] size_t                 getNumStates() const noexcept { return m_states.size(); }
+
+    /** @brief Remove all states. */
+    void clear() noexcept;
+
+private:
+    struct Hash
+    {
+        size_t operator()( const TextFormatState& state ) const noexcept;
+    };
+
+    std::vector<TextFormatState>                            m_states;
+    std::unordered_map<TextFormatState, juce::uint16, Hash> m_indices;
+};
+
+}  // namespace sd
@@ -0,0 +1,69 @@
+/*
+  =====================================================================================================
+
+    sd_ParseStats.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+/** Wraps statements that only exist when BBCODE_EDITOR_ENABLE_STATS is set. */
+#if BBCODE_EDITOR_ENABLE_STATS
+ #define BBCODE_STATS( ... ) __VA_ARGS__
+#else
+ #define BBCODE_STATS( ... )
+#endif
+
+
+namespace sd
+{
+
+/**
+ * @brief Statistics of one parse and commit call.
+ *
+ * Only collected when the module is compiled with BBCODE_EDITOR_ENABLE_STATS,
+ * otherwise none of the counting code exists.
+ *
+ * @see BBCodeParser::getLastParseStats, BBCodeEditor::getLastParseStats
+ */
+struct ParseStats
+{
+    size_t numBytes { 0 };            ///< Bytes of BBCode parsed.
+    size_t numTokens { 0 };           ///< Tokens returned by the tokenizer.
+    size_t numRuns { 0 };             ///< Runs in the parsed document.
+    size_t numMergedRuns { 0 };       ///< Text that continued the previous run, because its format did not change.
+    size_t maxStateDepth { 0 };       ///< Deepest nesting of format states, including the default state.
+    size_t numOverflowedTags { 0 };   ///< Format tags nested deeper than BBCodeParser::kMaxStateDepth, these are ignored.
+    size_t numUnknownTags { 0 };      ///< Tags that are not BBCode, or have an invalid value. Shown as text.
+    size_t numMalformedTags { 0 };    ///< Tags without closing ']'. Shown as text.
+    size_t numTypefaceLookups { 0 };  ///< Opening [font] and [code] tags, resolved through TypefaceNameCache.
+    size_t numFontLookups { 0 };      ///< Fonts fetched from FontCache while committing to the editor.
+    size_t numAllocations { 0 };      ///< (Re)allocations of the parser's text, run and state buffers.
+
+    double tokenizeSeconds { 0.0 };  ///< Time spent splitting the text into tokens.
+    double resolveSeconds { 0.0 };   ///< Time spent resolving tokens into format states and runs.
+    double commitSeconds { 0.0 };    ///< Time spent inserting the document into the editor.
+
+    /** @brief Adds the time it lives to a total. */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer( double& totalSeconds ) noexcept : m_totalSeconds( totalSeconds ) {}
+        ~ScopedTimer() { m_totalSeconds += juce::Time::highResolutionTicksToSeconds( juce::Time::getHighResolutionTicks() - m_start ); }
+
+    private:
+        double&           m_totalSeconds;
+        const juce::int64 m_start { juce::Time::getHighResolutionTicks() };
+
+        JUCE_DECLARE_NON_COPYABLE( ScopedTimer )
+    };
+};
+
+}  // namespace sd
@@ -22,6 +22,9 @@ namespace sd
  *
  * This includes: font family name, font height,
  * font style and font colour.
+ *
+ * States are small values: copying one is a plain memory copy.
+ * The font family is stored as an id, see TypefaceNameCache.
  */
 class TextFormatState
 {
@@ -30,7 +33,7 @@ public:
     static constexpr auto         kMinimumFontHeight { 1.0F };
     static constexpr auto         kMaximumFontHeight { 200.0F };
     static constexpr juce::uint32 kDefaultColour { 0xffffffffU };
-    static constexpr juce::uint32 kColourIDlength { 7 };
+    static constexpr auto         kHexColourPrefix { "#" };
 
     enum class StateChanged
     {
@@ -38,10 +41,14 @@ public:
         No
     };
 
-    using Parser = std::map<juce::String, std::function<StateChanged( const juce::String&, bool )>>;
+    TextFormatState( const juce::Colour& defaultColour = juce::Colour { kDefaultColour } ) noexcept : m_colour( defaultColour.getARGB() ) {}
 
-    TextFormatState( const juce::Colour& defaultColour = juce::Colour { kDefaultColour } ) noexcept
-      : m_colour( defaultColour ), m_defaultColour( defaultColour )
+    /** @brief Create a state from its stored values, see getFontHeight, getColour, getTypefaceId and getStyleFlags. */
+    TextFormatState( float fontHeight, const juce::Colour& colour, juce::uint16 typefaceId, int styleFlags ) noexcept
+      : m_fontHeight( fontHeight )
+      , m_colour( colour.getARGB() )
+      , m_fontId( typefaceId )
+      , m_styleFlags( static_cast<juce::uint8>( styleFlags ) )
     {
     }
 
@@ -53,15 +60,32 @@ public:
      *
      * @param token The BBCode token to be parsed.
      * @return      The newly created format state on successful parsing. Otherwise std::nullopt.
+     *
+     * @see withTag
+     */
+    std::optional<TextFormatState> withToken( std::string_view token ) const;
+
+    /** @copydoc withToken(std::string_view) const */
+    std::optional<TextFormatState> withToken( const juce::String& token ) const { return withToken( { token.toRawUTF8(), token.getNumBytesAsUTF8() } ); }
+
+    /**
+     * @brief Apply a tag that is already split up, as the tokenizer does.
+     *
+     * The built-in tags are matched first, then the ones in BBCodeTagRegistry.
+     *
+     * @param name   The tag name, without '/' and value. Case is ignored.
+     * @param value  Everything after '=' in the tag, empty if it has none.
+     * @param enable True for the opening tag, false for the closing one.
+     * @return       The newly created format state if the tag changes the format. Otherwise std::nullopt.
      */
-    std::optional<TextFormatState> withToken( const juce::String& token ) const;
+    std::optional<TextFormatState> withTag( std::string_view name, std::string_view value, bool enable ) const;
 
     /**
      * @brief Get the font, formatted according to the format state.
      *
      * @return The font with the correct style, size and font-family.
      *
-     * @see getColour
+     * @see getColour, FontCache
      */
     [[nodiscard]] juce::Font getFont() const;
 
@@ -72,33 +96,45 @@ public:
      *
      * @see getFont
      */
-    [[nodiscard]] juce::Colour getColour() const noexcept { return m_colour; }
+    [[nodiscard]] juce::Colour getColour() const noexcept { return juce::Colour { m_colour }; }
 
-private:
-    Parser       m_parser;
-    float        m_fontHeight { kDefaultFontHeight };
-    int          m_styleFlags { juce::Font::plain };
-    juce::String m_fontName {};
-    juce::Colour m_colour { kDefaultColour };
-    juce::Colour m_defaultColour { juce::Colours::black };
+    [[nodiscard]] float        getFontHeight() const noexcept { return m_fontHeight; }
+    [[nodiscard]] juce::uint16 getTypefaceId() const noexcept { return m_fontId; }  ///< See TypefaceNameCache.
+    [[nodiscard]] int          getStyleFlags() const noexcept { return m_styleFlags; }  ///< juce::Font::FontStyleFlags.
 
     /**
-     * Parse the supplied token.
-     * @return If the state has been changed (and needs pushing/popping).
+     * @name Setters for tags
+     *
+     * Used by the built-in tags and the ones in BBCodeTagRegistry.
+     * They return whether the state changed: a tag that changes nothing is shown as text.
+     *
+     * @param enable True for the opening tag, false for the closing one, which restores the default.
      */
-    StateChanged parseToken( const juce::String& token );
-    void         initialiseParser();
-
-    StateChanged setFont( const juce::String& fontName, bool enable );
-    StateChanged setHeight( const juce::String& height, bool enable ) noexcept;
+    ///@{
+    StateChanged setFont( std::string_view fontName, bool enable );
+    StateChanged setHeight( std::string_view height, bool enable ) noexcept;
     StateChanged setStyle( int style, bool enable ) noexcept;
-    StateChanged setColour( const juce::String& colour, bool enable );
+    StateChanged setColour( std::string_view colour, bool enable ) noexcept;
+    ///@}
 
-    static std::optional<juce::Colour> getBBcolor( const juce::String& colour );
+    /** @brief Compare the formatting of two states. */
+    [[nodiscard]] bool operator==( const TextFormatState& other ) const noexcept;
+    [[nodiscard]] bool operator!=( const TextFormatState& other ) const noexcept { return !operator==( other ); }
 
-    JUCE_LEAK_DETECTOR( TextFormatState )
+private:
+    float        m_fontHeight { kDefaultFontHeight };
+    juce::uint32 m_colour { kDefaultColour };
+    juce::uint16 m_fontId { TypefaceNameCache::kDefaultTypeface };
+    juce::uint8  m_styleFlags { juce::Font::plain };
+
+    StateChanged parseTag( std::string_view name, std::string_view value, bool enable );
+
+    static std::optional<juce::Colour> getBBcolor( std::string_view colour ) noexcept;
+    static std::optional<juce::Colour> getHexColour( std::string_view colour ) noexcept;
 };
 
+static_assert( std::is_trivially_copyable_v<TextFormatState>, "TextFormatState must stay a plain value" );
+
 
 namespace BBCode
 {
@@ -118,6 +154,31 @@ static constexpr auto kFontToken        = "font";
 static constexpr auto kQuoteToken       = "quote";
 static constexpr auto kBulletToken      = "*";
 
+static constexpr auto kBulletCharacter = u8"\u2022";
+static constexpr auto kOpenQuotes      = u8"\u201C";
+static constexpr auto kCloseQuotes     = u8"\u201D";
+static constexpr auto kTabCharacter    = "    ";
+static constexpr auto kNewLine         = "\n";
+
 }  // namespace BBCode
 
+/**
+ * @brief Compare text with a lower case name, ignoring the case of the text (ASCII only).
+ *
+ * @return Less than, equal to or greater than zero when the name sorts before, equal to or after the text.
+ */
+inline constexpr int compareIgnoreCase( std::string_view lowerCase, std::string_view text ) noexcept
+{
+    for( size_t i = 0; i < lowerCase.size() && i < text.size(); ++i )
+    {
+        const auto character = ( text[i] >= 'A' && text[i] <= 'Z' ) ? static_cast<char>( text[i] - 'A' + 'a' ) : text[i];
+        if( lowerCase[i] != character )
+            return lowerCase[i] < character ? -1 : 1;
+    }
+
+    if( lowerCase.size() == text.size() )
+        return 0;
+    return lowerCase.size() < text.size() ? -1 : 1;
+}
+
 }  // namespace sd
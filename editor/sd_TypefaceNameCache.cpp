@@ -0,0 +1,144 @@
+/*
+  =====================================================================================================
+
+    sd_TypefaceNameCache.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+
+namespace sd
+{
+
+//==============================================================================
+
+TypefaceNameCache& TypefaceNameCache::getInstance()
+{
+    static TypefaceNameCache instance;
+    return instance;
+}
+//==============================================================================
+
+juce::String TypefaceNameCache::resolve( const juce::String& familyName )
+{
+    return getTypefaceName( getTypefaceId( { familyName.toRawUTF8(), familyName.getNumBytesAsUTF8() } ) );
+}
+//==============================================================================
+
+juce::uint16 TypefaceNameCache::getTypefaceId( std::string_view familyName )
+{
+    {
+        const juce::ScopedReadLock lock( m_lock );
+
+        if( const auto resolved = m_resolved.find( familyName ); resolved != m_resolved.end() )
+            return resolved->second;
+    }
+
+    const juce::ScopedWriteLock lock( m_lock );
+
+    // Another thread may have resolved it in the meantime...
+    if( const auto resolved = m_resolved.find( familyName ); resolved != m_resolved.end() )
+        return resolved->second;
+
+    // Lookup font family in the system fonts...
+    const auto  requestedName = BBCodeTokenizer::toString( familyName );
+    auto        resolvedName  = requestedName;
+    const auto& systemFonts   = getTypefaceNames();
+    if( const auto* systemFont =
+          std::find_if( systemFonts.begin(), systemFonts.end(), [&requestedName]( const juce::String& x ) noexcept { return x.containsIgnoreCase( requestedName ); } );
+        systemFont != systemFonts.end() )
+    {
+        resolvedName = *systemFont;
+    }
+
+    const auto typefaceId = intern( requestedName, resolvedName );
+    m_resolved.emplace( familyName, typefaceId );
+    return typefaceId;
+}
+//==============================================================================
+
+std::optional<juce::uint16> TypefaceNameCache::findTypefaceId( std::string_view typefaceName )
+{
+    if( typefaceName.empty() )
+        return kDefaultTypeface;
+
+    const juce::ScopedReadLock lock( m_lock );
+
+    if( const auto typefaceId = m_ids.find( typefaceName ); typefaceId != m_ids.end() )
+        return typefaceId->second;
+    return std::nullopt;
+}
+//==============================================================================
+
+juce::String TypefaceNameCache::getTypefaceName( juce::uint16 typefaceId )
+{
+    const juce::ScopedReadLock lock( m_lock );
+
+    jassert( typefaceId < m_names.size() );
+    return typefaceId < m_names.size() ? m_names[typefaceId] : juce::String();
+}
+//==============================================================================
+
+juce::String TypefaceNameCache::getRequestedName( juce::uint16 typefaceId )
+{
+    const juce::ScopedReadLock lock( m_lock );
+
+    jassert( typefaceId < m_requestedNames.size() );
+    return typefaceId < m_requestedNames.size() ? m_requestedNames[typefaceId] : juce::String();
+}
+//==============================================================================
+
+juce::uint16 TypefaceNameCache::intern( const juce::String& requestedName, const juce::String& typefaceName )
+{
+    if( typefaceName.isEmpty() )
+        return kDefaultTypeface;
+
+    // Names resolving to the same typeface share its id, so their states compare equal...
+    const std::string name { typefaceName.toRawUTF8() };
+    if( const auto typefaceId = m_ids.find( name ); typefaceId != m_ids.end() )
+        return typefaceId->second;
+
+    // Ids are 16 bits, running out would take tens of thousands of typefaces...
+    jassert( m_names.size() < kNoTypeface );
+    if( m_names.size() >= kNoTypeface )
+        return kDefaultTypeface;
+
+    const auto typefaceId = static_cast<juce::uint16>( m_names.size() );
+    m_names.push_back( typefaceName );
+    m_requestedNames.push_back( requestedName );
+    m_ids.emplace( name, typefaceId );
+    return typefaceId;
+}
+//==============================================================================
+
+void TypefaceNameCache::prewarm()
+{
+    juce::Thread::launch( [this] {
+        const juce::ScopedWriteLock lock( m_lock );
+        getTypefaceNames();
+    } );
+}
+//==============================================================================
+
+void TypefaceNameCache::invalidate()
+{
+    const juce::ScopedWriteLock lock( m_lock );
+    m_typefaceNames.reset();
+    m_resolved.clear();
+}
+//==============================================================================
+
+const juce::StringArray& TypefaceNameCache::getTypefaceNames()
+{
+    if( !m_typefaceNames.has_value() )
+        m_typefaceNames = juce::Font::findAllTypefaceNames();
+    return *m_typefaceNames;
+}
+//==============================================================================
+
+}  // namespace sd
@@ -0,0 +1,109 @@
+/*
+  =====================================================================================================
+
+    sd_TypefaceNameCache.h
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+*/
+
+#pragma once
+
+
+namespace sd
+{
+
+/**
+ * @brief Process wide cache of typeface name lookups.
+ *
+ * Enumerating the system typefaces is slow (on Linux it goes through
+ * fontconfig), so it is done once. Resolved names are remembered, which
+ * makes repeated [font=...] and [code] tags cheap.
+ *
+ * All functions are thread safe. Names that were looked up before are found
+ * under a read lock, so parallel parsers do not wait for each other.
+ */
+class TypefaceNameCache
+{
+public:
+    static constexpr juce::uint16 kDefaultTypeface { 0 };   ///< Id of the empty name: the default typeface.
+    static constexpr juce::uint16 kNoTypeface { 0xffffU };  ///< Never a valid id.
+
+    /** @brief Get the process wide instance. */
+    static TypefaceNameCache& getInstance();
+
+    /**
+     * @brief Find the system typeface for a font family name.
+     *
+     * @param familyName The requested family name.
+     * @return           The first system typeface containing the name (ignoring case),
+     *                   or the requested name itself if there is none.
+     */
+    [[nodiscard]] juce::String resolve( const juce::String& familyName );
+
+    /**
+     * @brief Find the system typeface for a font family name.
+     *
+     * Same as resolve(), but returns the id of the resolved name. Names that resolve
+     * to the same typeface, e.g. "Arial" and "arial", get the same id.
+     *
+     * @see getTypefaceName
+     */
+    [[nodiscard]] juce::uint16 getTypefaceId( std::string_view familyName );
+
+    /**
+     * @brief Get the id of a typeface name, without resolving it.
+     *
+     * @return The id, or std::nullopt if the name never was the result of a lookup.
+     */
+    [[nodiscard]] std::optional<juce::uint16> findTypefaceId( std::string_view typefaceName );
+
+    /** @brief Get the typeface name belonging to an id. */
+    [[nodiscard]] juce::String getTypefaceName( juce::uint16 typefaceId );
+
+    /**
+     * @brief Get the font family name an id was first requested with, before it was resolved.
+     *
+     * Unlike the typeface name, this does not depend on the fonts of this machine. Other
+     * names that resolved to the same typeface here are not kept.
+     *
+     * @see getTypefaceId
+     */
+    [[nodiscard]] juce::String getRequestedName( juce::uint16 typefaceId );
+
+    /**
+     * @brief Enumerate the system typefaces on a background thread.
+     *
+     * Call this at startup so the first lookup does not have to wait.
+     */
+    void prewarm();
+
+    /**
+     * @brief Forget all lookups.
+     *
+     * Call this after typefaces have been installed or removed.
+     * Ids handed out before stay valid.
+     */
+    void invalidate();
+
+private:
+    juce::ReadWriteLock                              m_lock;
+    std::optional<juce::StringArray>                 m_typefaceNames;
+    std::map<std::string, juce::uint16, std::less<>> m_resolved;
+    std::map<std::string, juce::uint16, std::less<>> m_ids;
+    std::vector<juce::String>                        m_names { juce::String() };
+    std::vector<juce::String>                        m_requestedNames { juce::String() };  // The first requested name of every id.
+
+    TypefaceNameCache() = default;
+
+    const juce::StringArray& getTypefaceNames();
+    juce::uint16             intern( const juce::String& requestedName, const juce::String& typefaceName );
+
+    JUCE_DECLARE_NON_COPYABLE( TypefaceNameCache )
+};
+
+}  // namespace sd
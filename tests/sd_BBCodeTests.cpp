@@ -0,0 +1,465 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeTests.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+
+    Unit tests of the bbcode_editor module, in the "BBCode" juce::UnitTest category.
+
+    Usage: BBCodeTests
+
+    Returns 0 when all tests pass.
+
+  =====================================================================================================
+*/
+
+#include <bbcode_editor.h>
+
+
+namespace sd
+{
+
+//==============================================================================
+
+class CompiledBBDocumentTests : public juce::UnitTest
+{
+public:
+    CompiledBBDocumentTests() : juce::UnitTest( "CompiledBBDocument", "BBCode" ) {}
+
+    void runTest() override
+    {
+        beginTest( "Font families are stored as requested, not as resolved" );
+
+        // Not installed anywhere, so it only survives if the blob keeps the name from the BBCode...
+        constexpr std::string_view kFamily { "No Such Family 5f2c" };
+
+        BBCodeParser parser;
+        const auto   blob = CompiledBBDocument::compile( parser.parse( std::string_view { "[font=No Such Family 5f2c]a[/font][code]b[/code]" } ) );
+
+        const std::string_view bytes { static_cast<const char*>( blob.getData() ), blob.getSize() };
+        expect( bytes.find( kFamily ) != std::string_view::npos );
+        expect( bytes.find( "courier" ) != std::string_view::npos );
+
+        // The monospace family this machine picked must not end up in the blob...
+        auto&      typefaces = TypefaceNameCache::getInstance();
+        const auto monospace = typefaces.resolve( "courier" );
+        if( monospace != "courier" )
+            expect( bytes.find( monospace.toRawUTF8() ) == std::string_view::npos );
+
+        beginTest( "Opening resolves the requested families" );
+
+        const CompiledBBDocument document { blob.getData(), blob.getSize() };
+        expect( document.isValid() );
+
+        juce::StringArray requested;
+        for( size_t index = 0; index < document.getNumRuns(); ++index )
+        {
+            const auto typefaceId = document.getState( document.getRun( index ) ).getTypefaceId();
+            if( typefaceId != TypefaceNameCache::kDefaultTypeface )
+                requested.addIfNotAlreadyThere( typefaces.getRequestedName( typefaceId ) );
+        }
+        expect( requested.contains( BBCodeTokenizer::toString( kFamily ) ) );
+        expect( requested.contains( "courier" ) );
+
+        beginTest( "Families that resolve to the same typeface share its id" );
+
+        // Only testable when an installed typeface matches...
+        if( monospace != "courier" )
+        {
+            const auto sameFamily = parser.parse( std::string_view { "[font=Courier]a[/font][font=COURIER]b[/font]" } );
+            expectEquals( static_cast<int>( sameFamily.getNumRuns() ), 1, "Equal states continue the run" );
+
+            // A tag that changes nothing is shown as text...
+            const auto nested = parser.parse( std::string_view { "[font=courier][font=COURIER]b" } );
+            expect( nested.getText() == "[font=COURIER]b" );
+        }
+
+        beginTest( "Damaged blobs and blobs of another version are rejected" );
+
+        int numAccepted { 0 };
+        for( size_t size = 0; size < blob.getSize(); ++size )
+        {
+            const CompiledBBDocument truncated { blob.getData(), size };
+            numAccepted += truncated.isValid() || truncated.getNumRuns() > 0 || !truncated.getText().empty() ? 1 : 0;
+        }
+        expectEquals( numAccepted, 0, "Truncated blobs" );
+
+        juce::MemoryBlock badMagic { blob };
+        static_cast<char*>( badMagic.getData() )[0] = 'X';
+        expect( !CompiledBBDocument { badMagic.getData(), badMagic.getSize() }.isValid() );
+
+        juce::MemoryBlock newerVersion { blob };
+        static_cast<juce::uint8*>( newerVersion.getData() )[4] = static_cast<juce::uint8>( CompiledBBDocument::kVersion + 1 );
+        expect( !CompiledBBDocument { newerVersion.getData(), newerVersion.getSize() }.isValid() );
+
+        BBCodeEditor editor;
+        editor.setBBText( "kept" );
+        expect( !editor.setCompiledBBText( newerVersion.getData(), newerVersion.getSize() ) );
+        expect( editor.getText() == "kept", "The editor is left untouched" );
+        expect( editor.setCompiledBBText( blob.getData(), blob.getSize() ) );
+        expect( editor.getText() == BBCodeTokenizer::toString( document.getText() ) );
+    }
+};
+
+static CompiledBBDocumentTests compiledBBDocumentTests;
+//==============================================================================
+
+class BBPlainTextTests : public juce::UnitTest
+{
+public:
+    BBPlainTextTests() : juce::UnitTest( "BBPlainText", "BBCode" ) {}
+
+    void runTest() override
+    {
+        beginTest( "The text is the text of the parsed document" );
+
+        constexpr std::string_view kBBText { "[b]bold[/b] [quote=Ann]hi[/quote][code]x = 1;[/code][*]item [unknown]tag" };
+
+        BBCodeParser parser;
+        const auto   document = parser.parse( kBBText );
+        const auto   plain    = createPlainText( kBBText );
+        expect( plain.text == document.getText() );
+        expect( plain.text.find( '\r' ) == std::string::npos, "Line breaks are a single newline" );
+
+        beginTest( "Segments map the text back to the source" );
+
+        for( const std::string_view word : { "bold", "Ann", "x = 1;", "item", "[unknown]tag" } )
+        {
+            const auto textOffset = plain.text.find( word );
+            expect( textOffset != std::string::npos );
+            expectEquals( static_cast<int>( plain.getSourceOffset( textOffset ) ), static_cast<int>( kBBText.find( word ) ) );
+        }
+
+        // The bullet was added by [*]...
+        const auto bullet = plain.text.find( BBCode::kBulletCharacter );
+        expectEquals( static_cast<int>( plain.getSourceOffset( bullet ) ), static_cast<int>( kBBText.find( "[*]" ) ) );
+    }
+};
+
+static BBPlainTextTests bbPlainTextTests;
+//==============================================================================
+
+class BBCodeParserTests : public juce::UnitTest
+{
+public:
+    BBCodeParserTests() : juce::UnitTest( "BBCodeParser", "BBCode" ) {}
+
+    void runTest() override
+    {
+        beginTest( "Documents have the runs and formats BBCodeEditor always showed" );
+
+        constexpr juce::uint32 kText { 0xff101010 };
+        constexpr auto         kBold   = juce::Font::bold;
+        constexpr auto         kItalic = juce::Font::italic;
+
+        // As the editor rendered them before the text was parsed into documents...
+        const Expected corpus[] {
+            { "plain text", { { "plain text", 0, 15, kText, {} } } },
+            { "[b]bold [i]both[/i][/b] [u]under[/u]",
+              { { "bold ", kBold, 15, kText, {} }, { "both", kBold | kItalic, 15, kText, {} }, { " ", 0, 15, kText, {} }, { "under", juce::Font::underlined, 15, kText, {} } } },
+            { "[color=red]red[/color] [color=#00ff00]green[/color]",
+              { { "red", 0, 15, 0xffff0000, {} }, { " ", 0, 15, kText, {} }, { "green", 0, 15, 0xff00ff00, {} } } },
+            { "[size=20]big[/size] small", { { "big", 0, 20, kText, {} }, { " small", 0, 15, kText, {} } } },
+            { "[font=serif]serif[/font]", { { "serif", 0, 15, kText, "serif" } } },
+            { "[code]x = 1;[/code]", { { "\n\n    x = 1;\n\n", 0, 15, kText, "courier" } } },
+            { "[quote=Ann]hello[/quote] after",
+              { { "\n\n|    ", kItalic, 15, kText, {} },
+                { "Ann: ", kBold | kItalic, 15, kText, {} },
+                { "\u201chello\u201d", kItalic, 15, kText, {} },
+                { " after", 0, 15, kText, {} } } },
+            { "[*]one\n[*]two", { { "\u2022    one\n\u2022    two", 0, 15, kText, {} } } },
+            { "[unknown]tag [/b] [b", { { "[unknown]tag [/b] ", 0, 15, kText, {} } } },
+            { "[B]upper[/B] [Color=blue]x[/color]", { { "upper", kBold, 15, kText, {} }, { " ", 0, 15, kText, {} }, { "x", 0, 15, 0xff0000ff, {} } } },
+            { "[b][b]nested[/b][/b]", { { "nested", kBold, 15, kText, {} } } },
+            { "\u00e9t\u00e9 [i]\u20ac[/i]", { { "\u00e9t\u00e9 ", 0, 15, kText, {} }, { "\u20ac", kItalic, 15, kText, {} } } },
+        };
+
+        BBCodeParser parser;
+        for( const auto& expected : corpus )
+        {
+            parser.reset( juce::Colour { kText } );
+            const auto segments = getSegments( parser.parseNext( expected.bbText ) );
+            expect( segments == expected.segments, BBCodeTokenizer::toString( expected.bbText ) );
+        }
+
+        parser.reset( juce::Colour { kText } );
+        expect( parser.parseNext( std::string_view { "[align=center]centred" } ).getAlignment() == BBDocument::Alignment::centre );
+
+        beginTest( "Parsing on from a checkpoint gives the rest of a full parse" );
+
+        // Tags open across checkpoints, quotes, lists and a change of alignment halfway...
+        std::string bbText;
+        for( int line = 0; bbText.size() < 12 * BBCodeParser::kCheckpointInterval; ++line )
+        {
+            bbText += "[color=#" + std::to_string( 100000 + line % 7 ) + "]line " + std::to_string( line ) + " [b]bold";
+            bbText += line % 5 == 0 ? "[/color] [quote=Ann]quoted[/quote] " : " [*]item ";
+            bbText += line % 3 == 0 ? "[/b]\n" : "[code]x[/code][/b][/color]\n";
+            if( line == 200 )
+                bbText += "[align=right]";
+        }
+
+        std::vector<BBCodeParser::Checkpoint> checkpoints;
+        parser.reset( juce::Colour { kText } );
+        const auto full = parser.parseNext( bbText, &checkpoints );
+        expect( checkpoints.size() > 8 );
+
+        int numDifferent { 0 };
+        for( const auto& checkpoint : checkpoints )
+        {
+            parser.restore( checkpoint );
+            const auto rest = parser.parseNext( std::string_view { bbText }.substr( checkpoint.sourceOffset ) );
+            if( getSegments( rest ) != getSegments( full, checkpoint.runIndex ) || rest.getAlignment() != full.getAlignment() )
+                ++numDifferent;
+        }
+        expectEquals( numDifferent, 0 );
+
+        beginTest( "Appended text keeps its format past the size of the state table" );
+
+        // Every chunk brings a colour of its own, as appendBBText or BBCodeStreamParser would...
+        constexpr auto kNumChunks = static_cast<juce::uint32>( FormatStateTable::kMaxNumStates + 16 );
+
+        parser.reset( juce::Colour { TextFormatState::kDefaultColour } );
+        [[maybe_unused]] const auto openTag = parser.parseNext( std::string_view { "[b]" } );
+
+        int numUnformatted { 0 };
+        for( juce::uint32 chunk = 0; chunk < kNumChunks; ++chunk )
+        {
+            std::array<char, 32> bbText {};
+            const auto           length   = std::snprintf( bbText.data(), bbText.size(), "[color=#%06x]x[/color]", static_cast<unsigned int>( chunk ) );
+            const auto           document = parser.parseNext( { bbText.data(), static_cast<size_t>( length ) } );
+
+            const auto& state = document.getState( document.getRun( 0 ) );
+            if( document.getNumRuns() != 1 || state.getColour() != juce::Colour { 0xff000000U | chunk } || ( state.getStyleFlags() & juce::Font::bold ) == 0 )
+                ++numUnformatted;
+        }
+        expectEquals( numUnformatted, 0 );
+
+        beginTest( "Only opening font and code tags count as typeface lookups" );
+
+        [[maybe_unused]] const auto fonts = parser.parse( std::string_view { "[font=serif]a[/font][code]b[/code][/font][b]c[/b]" } );
+        expectEquals( static_cast<int>( parser.getLastParseStats().numTypefaceLookups ), 2 );
+
+        beginTest( "Format tags ignore case, code, quote and align match the start of the tag" );
+
+        // Formats like [code], without the padding of a code block...
+        const auto upperCaseCode = parser.parse( std::string_view { "[CODE]x[/CODE]" } );
+        expect( upperCaseCode.getText() == "x" );
+        expect( ( upperCaseCode.getRun( 0 ).flags & BBDocument::code ) == 0 );
+        expect( upperCaseCode.getState( upperCaseCode.getRun( 0 ) ).getTypefaceId() != TypefaceNameCache::kDefaultTypeface );
+
+        // Padded like a code block, but shown as text...
+        const auto codeBlock = parser.parse( std::string_view { "[codeblock]x" } );
+        expect( codeBlock.getText().find( "[codeblock]x" ) != std::string_view::npos );
+        expect( ( codeBlock.getRun( 0 ).flags & BBDocument::code ) != 0 );
+
+        // Italic, without quote marks...
+        const auto upperCaseQuote = parser.parse( std::string_view { "[QUOTE=Ann]x[/QUOTE]" } );
+        expect( upperCaseQuote.getText() == "x" );
+        expect( ( upperCaseQuote.getState( upperCaseQuote.getRun( 0 ) ).getStyleFlags() & juce::Font::italic ) != 0 );
+
+        // Quoted, but shown as text...
+        const auto quotes = parser.parse( std::string_view { "[quotes]x" } );
+        expect( quotes.getText().find( "[quotes]x" ) != std::string_view::npos );
+        expect( ( quotes.getRun( 0 ).flags & BBDocument::quote ) != 0 );
+
+        const auto upperCaseAlign = parser.parse( std::string_view { "[ALIGN=center]x" } );
+        expect( upperCaseAlign.getText() == "[ALIGN=center]x" );
+        expect( upperCaseAlign.getAlignment() == BBDocument::Alignment::left );
+
+        beginTest( "Application tags can not take the names of built-in tags" );
+
+        auto&      tags      = BBCodeTagRegistry::getInstance();
+        const auto underline = []( TextFormatState& state, std::string_view /*value*/, bool enable ) noexcept {
+            return state.setStyle( juce::Font::underlined, enable );
+        };
+        for( const std::string_view name : { "b", "Size", "CODE", "codeblock", "quotes", "alignment" } )
+            expect( !tags.add( name, underline ), juce::String { "Added " } + BBCodeTokenizer::toString( name ) );
+
+        expect( tags.add( "sdtestlink", underline ) );
+        const auto link = parser.parse( std::string_view { "[SdTestLink]x[/sdtestlink]" } );
+        expect( link.getText() == "x" );
+        expect( ( link.getState( link.getRun( 0 ) ).getStyleFlags() & juce::Font::underlined ) != 0 );
+    }
+
+private:
+    struct Segment
+    {
+        std::string  text;
+        int          styleFlags { 0 };
+        float        height { 0.0F };
+        juce::uint32 colour { 0 };
+        juce::String typeface;  // As requested, empty for the default typeface.
+
+        bool operator==( const Segment& other ) const
+        {
+            return text == other.text && styleFlags == other.styleFlags && height == other.height && colour == other.colour && typeface == other.typeface;
+        }
+    };
+
+    struct Expected
+    {
+        std::string_view     bbText;
+        std::vector<Segment> segments;
+    };
+
+    // Consecutive runs with the same format state, as BBCodeEditor inserts them...
+    static std::vector<Segment> getSegments( const BBDocument& document, size_t firstRun = 0 )
+    {
+        std::vector<Segment> segments;
+        for( auto index = firstRun; index < document.getNumRuns(); ++index )
+        {
+            const auto& run = document.getRun( index );
+            if( index > firstRun && run.state == document.getRun( index - 1 ).state )
+            {
+                segments.back().text += document.getText( run );
+                continue;
+            }
+
+            const auto& state    = document.getState( run );
+            const auto  typeface = state.getTypefaceId();
+            segments.push_back( { std::string { document.getText( run ) }, state.getStyleFlags(), state.getFontHeight(), state.getColour().getARGB(),
+                                  typeface == TypefaceNameCache::kDefaultTypeface ? juce::String {} : TypefaceNameCache::getInstance().getRequestedName( typeface ) } );
+        }
+        return segments;
+    }
+};
+
+static BBCodeParserTests bbCodeParserTests;
+//==============================================================================
+
+class BBCodeEditorTests : public juce::UnitTest
+{
+public:
+    BBCodeEditorTests() : juce::UnitTest( "BBCodeEditor", "BBCode" ) {}
+
+    void runTest() override
+    {
+        beginTest( "Text ending in a colour keeps the default colour" );
+
+        constexpr juce::uint32 kDefaultColour { 0xff202020 };
+
+        juce::String bbText;
+        for( int line = 0; bbText.length() < 8 * static_cast<int>( BBCodeParser::kCheckpointInterval ); ++line )
+            bbText << "line " << line << " [b]bold[/b]\n";
+        bbText << "[color=red]x";
+
+        BBCodeEditor editor;
+        editor.setColour( juce::TextEditor::textColourId, juce::Colour { kDefaultColour } );
+        editor.setBBText( bbText );
+        expect( editor.findColour( juce::TextEditor::textColourId ) == juce::Colour { kDefaultColour }, "The text colour is put back" );
+        expect( editor.getDefaultColour() == juce::Colour { kDefaultColour } );
+
+        beginTest( "Changing the end only parses the end again" );
+
+        editor.setBBText( bbText + "y" );
+        expect( editor.getLastParseStats().numBytes < BBCodeParser::kCheckpointInterval * 2, "setBBText took the checkpoint diff" );
+        expect( editor.getDefaultColour() == juce::Colour { kDefaultColour } );
+
+        BBCodeEditor fresh;
+        fresh.setColour( juce::TextEditor::textColourId, juce::Colour { kDefaultColour } );
+        fresh.setBBText( bbText + "y" );
+        expect( editor.getText() == fresh.getText() );
+        expect( editor.getLastParseStats().numBytes < fresh.getLastParseStats().numBytes );
+
+        beginTest( "A new default colour renders everything again" );
+
+        editor.setColour( juce::TextEditor::textColourId, juce::Colours::green );
+        editor.setBBText( bbText + "y" );
+        expectEquals( editor.getLastParseStats().numBytes, fresh.getLastParseStats().numBytes );
+        expect( editor.getDefaultColour() == juce::Colours::green );
+
+        beginTest( "Edits anywhere render like a fresh setBBText" );
+
+        const auto insertAt = []( const juce::String& text, int index, const juce::String& insert ) {
+            return text.substring( 0, index ) + insert + text.substring( index );
+        };
+        const auto         middle = bbText.length() / 2;
+        const juce::String edits[] {
+            insertAt( bbText, middle, "[i]" ),                   // Opens a tag halfway, everything after it changes.
+            insertAt( bbText, middle, "[/b][/i]" ),              // Closes what is not open.
+            bbText.substring( 0, middle ),                       // Cuts the end off.
+            insertAt( bbText, 10, "[quote=Ann]" ),               // Changes the start.
+            bbText.replace( "[color=red]x", "[align=right]z" ),  // Changes the alignment of everything.
+            bbText,
+        };
+
+        BBCodeEditor edited;
+        edited.setColour( juce::TextEditor::textColourId, juce::Colour { kDefaultColour } );
+        edited.setBBText( bbText );
+        for( const auto& edit : edits )
+        {
+            edited.setBBText( edit );
+
+            BBCodeEditor rendered;
+            rendered.setColour( juce::TextEditor::textColourId, juce::Colour { kDefaultColour } );
+            rendered.setBBText( edit );
+            expect( edited.getText() == rendered.getText() );
+            expect( edited.getJustificationType().getFlags() == rendered.getJustificationType().getFlags() );
+        }
+
+        beginTest( "A newer update cancels a pending setBBTextAsync" );
+
+        bool firstDone { false };
+        bool thirdDone { false };
+        bool fourthDone { false };
+
+        BBCodeEditor asyncEditor;
+        asyncEditor.setBBTextAsync( "[b]first[/b]", [&firstDone] { firstDone = true; } );
+        asyncEditor.setBBText( "second" );
+        asyncEditor.setBBTextAsync( "[i]third[/i]", [&thirdDone] { thirdDone = true; } );
+        asyncEditor.setBBTextAsync( "[u]fourth[/u]", [&fourthDone] { fourthDone = true; } );
+
+        for( const auto timeout = juce::Time::getMillisecondCounter() + 5000; !fourthDone && juce::Time::getMillisecondCounter() < timeout; )
+            juce::MessageManager::getInstance()->runDispatchLoopUntil( 10 );
+
+        expect( fourthDone );
+        expect( !firstDone && !thirdDone, "Cancelled updates do not report they are done" );
+        expect( asyncEditor.getText() == "fourth" );
+
+        beginTest( "The document cache is keyed on the default colour" );
+
+        const juce::String redEnd { "first [color=red]x" };
+        const juce::String blueEnd { "second [color=blue]y" };
+
+        BBDocumentCache cache;
+        BBCodeEditor    cachedEditor;
+        cachedEditor.setColour( juce::TextEditor::textColourId, juce::Colour { kDefaultColour } );
+        cachedEditor.setDocumentCache( &cache );
+        cachedEditor.setBBText( redEnd );
+        cachedEditor.setBBText( blueEnd );
+        cachedEditor.setBBText( redEnd );
+
+        const auto statistics = cache.getStatistics();
+        expectEquals( static_cast<int>( statistics.hits ), 1, "The same text hits, however the previous one ended" );
+        expectEquals( static_cast<int>( statistics.numEntries ), 2 );
+        expect( cache.find( redEnd, juce::Colour { kDefaultColour } ) != nullptr );
+        expect( cache.find( redEnd, juce::Colours::blue ) == nullptr, "Nothing was parsed with a colour of the text as default" );
+    }
+};
+
+static BBCodeEditorTests bbCodeEditorTests;
+//==============================================================================
+
+}  // namespace sd
+
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure( false );
+    runner.runTestsInCategory( "BBCode" );
+
+    int numFailures { 0 };
+    for( int index = 0; index < runner.getNumResults(); ++index )
+        numFailures += runner.getResult( index )->failures;
+
+    return numFailures > 0 ? 1 : 0;
+}
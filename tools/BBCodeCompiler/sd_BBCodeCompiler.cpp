@@ -0,0 +1,98 @@
+/*
+  =====================================================================================================
+
+    sd_BBCodeCompiler.cpp
+    Created  : 10 Apr 2022 1:08:13am
+    Author   : Marcel Huibers
+    Project  : SD Toolkit
+    Company  : Sound Development
+    Copyright: Marcel Huibers (c) 2022 All Rights Reserved
+
+  =====================================================================================================
+
+    Converts BBCode files into the compiled format read by BBCodeEditor::setCompiledBBText,
+    e.g. to embed them with BinaryData.
+
+    Usage: BBCodeCompiler [--colour AARRGGBB] [--output-dir <dir>] <file.bbcode> ...
+
+    Every input file is written next to it (or into the output directory) with the .bbc
+    extension. The colour is the text colour of the editor the text is meant for, it
+    defaults to white.
+
+  =====================================================================================================
+*/
+
+#include <bbcode_editor.h>
+
+#include <cstdio>
+
+
+namespace
+{
+
+//==============================================================================
+
+int printUsage( const char* executable )
+{
+    std::printf( "Usage: %s [--colour AARRGGBB] [--output-dir <dir>] <file.bbcode> ...\n", executable );
+    return 1;
+}
+//==============================================================================
+
+bool compileFile( const juce::File& input, const juce::File& outputDirectory, const juce::Colour& defaultColour )
+{
+    if( !input.existsAsFile() )
+    {
+        std::printf( "%s: file not found\n", input.getFullPathName().toRawUTF8() );
+        return false;
+    }
+
+    sd::BBCodeParser parser { defaultColour };
+    const auto       blob   = sd::CompiledBBDocument::compile( parser.parse( input.loadFileAsString() ) );
+    const auto       output = outputDirectory.getChildFile( input.getFileNameWithoutExtension() ).withFileExtension( ".bbc" );
+
+    if( !output.replaceWithData( blob.getData(), blob.getSize() ) )
+    {
+        std::printf( "%s: could not write\n", output.getFullPathName().toRawUTF8() );
+        return false;
+    }
+
+    std::printf( "%s -> %s (%zu bytes)\n", input.getFullPathName().toRawUTF8(), output.getFullPathName().toRawUTF8(), blob.getSize() );
+    return true;
+}
+//==============================================================================
+
+}  // namespace
+
+
+int main( int argc, char* argv[] )
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto                      defaultColour = juce::Colour { sd::TextFormatState::kDefaultColour };
+    std::optional<juce::File> outputDirectory;
+    juce::Array<juce::File>   inputs;
+
+    for( int index = 1; index < argc; ++index )
+    {
+        const juce::String argument { argv[index] };
+
+        if( argument == "--colour" && index + 1 < argc )
+            defaultColour = juce::Colour( static_cast<juce::uint32>( juce::String( argv[++index] ).getHexValue64() ) );
+        else if( argument == "--output-dir" && index + 1 < argc )
+            outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile( argv[++index] );
+        else if( argument.startsWith( "--" ) )
+            return printUsage( argv[0] );
+        else
+            inputs.add( juce::File::getCurrentWorkingDirectory().getChildFile( argument ) );
+    }
+
+    if( inputs.isEmpty() )
+        return printUsage( argv[0] );
+
+    bool succeeded = true;
+    for( const auto& input : inputs )
+        succeeded = compileFile( input, outputDirectory.value_or( input.getParentDirectory() ), defaultColour ) && succeeded;
+
+    return succeeded ? 0 : 1;
+}